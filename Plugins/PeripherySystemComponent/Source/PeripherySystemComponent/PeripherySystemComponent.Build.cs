@@ -17,7 +17,9 @@ public class PeripherySystemComponent : ModuleRules
 				"Engine",
 				"NetCore",
 				"PhysicsCore",
-				"DataRegistry"
+				"DataRegistry",
+				"AIModule",
+				"GameplayTags"
 			}
 		);
 
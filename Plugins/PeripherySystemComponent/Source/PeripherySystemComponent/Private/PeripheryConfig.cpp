@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryConfig.h"
+
+#include "PlayerPeripheriesComponent.h"
+#include "GameFramework/Pawn.h"
+#include "Logging/StructuredLog.h"
+
+
+UPeripheryConfig::UPeripheryConfig()
+{
+	/** Periphery Radius */
+	PeripheryRadiusChannel = ECC_Pawn;
+	RadiusFilter.ValidClasses.Add(APawn::StaticClass());
+	bDebugPeripheryRadius = false;
+
+	/** Radius Rings */
+	RadiusRingsUpdateInterval = 0.1;
+	bShareRadiusRingQueries = false;
+	SharedQueryCellSize = 200;
+	bPredictRadiusRings = false;
+	RadiusRingsMaxPredictedSpeed = 1200;
+	bDebugRadiusRings = false;
+
+	/** Item Detection */
+	ItemDetectionChannel = ECC_GameTraceChannel1;
+	ItemDetectionFilter.ValidClasses.Add(AActor::StaticClass());
+	bDebugItemDetection = false;
+
+	/** Periphery Cone */
+	PeripheryConeChannel = ECC_Pawn;
+	ConeFilter.ValidClasses.Add(APawn::StaticClass());
+	bDebugPeripheryCone = false;
+
+	/** Periphery Trace */
+	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery2);
+	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery3);
+	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery1);
+	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery4);
+	TraceFilter.ValidClasses.Add(AActor::StaticClass());
+	PeripheryTraceDistance = 6400;
+	PeripheryTraceForwardOffset = 34.0;
+	bPrefilterTrace = false;
+	TraceShouldIgnoreOwnerActors = true;
+	bDebugPeripheryTrace = false;
+	bDrawTraceDebug = false;
+
+	/** Highlight */
+	HighlightPeripheries = 0;
+	HighlightStencilValues.Add(EPeripheryType::EPT_Enemy, 2);
+	HighlightStencilValues.Add(EPeripheryType::EPT_Ally, 3);
+	HighlightStencilValues.Add(EPeripheryType::EPT_Object, 4);
+	DefaultHighlightStencilValue = 1;
+}
+
+
+FPrimaryAssetId UPeripheryConfig::GetPrimaryAssetId() const
+{
+	// Instanced overrides aren't assets, only the configs saved in the content browser are primary assets
+	if (!GetOuter() || !GetOuter()->IsA<UPackage>()) return FPrimaryAssetId();
+	return FPrimaryAssetId(TEXT("PeripheryConfig"), GetFName());
+}
+
+
+void UPeripheryConfig::PostLoad()
+{
+	Super::PostLoad();
+	CompileFilters();
+}
+
+
+#if WITH_EDITOR
+void UPeripheryConfig::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+	CompileFilters();
+}
+#endif
+
+
+const FPeripheryFilter* UPeripheryConfig::GetFilter(const EPeripheryKind Kind, const int32 RingIndex) const
+{
+	switch (Kind)
+	{
+		case EPeripheryKind::EPK_Radius: return &RadiusFilter;
+		case EPeripheryKind::EPK_Cone: return &ConeFilter;
+		case EPeripheryKind::EPK_Trace: return &TraceFilter;
+		case EPeripheryKind::EPK_ItemDetection: return &ItemDetectionFilter;
+		case EPeripheryKind::EPK_RadiusRing: return RadiusRings.IsValidIndex(RingIndex) ? &RadiusRings[RingIndex].Filter : nullptr;
+		default: return nullptr;
+	}
+}
+
+
+bool UPeripheryConfig::PassesFilter(const EPeripheryKind Kind, const AActor* Actor, const EPeripheryType PeripheryType, const int32 RingIndex) const
+{
+	if (Kind == EPeripheryKind::EPK_RadiusRing && !RadiusRings.IsValidIndex(RingIndex)) return false;
+	const int32 FilterIndex = GetFilterIndex(Kind, RingIndex);
+	if (!GetFilter(Kind, RingIndex) || FilterIndex == INDEX_NONE) return Actor != nullptr;
+	if (!CompiledFilters.IsCompiled()) CompileFilters();
+	return CompiledFilters.Passes(FilterIndex, Actor, PeripheryType);
+}
+
+
+bool UPeripheryConfig::FilterUsesPeripheryTypes(const EPeripheryKind Kind, const int32 RingIndex) const
+{
+	const int32 FilterIndex = GetFilterIndex(Kind, RingIndex);
+	if (!GetFilter(Kind, RingIndex) || FilterIndex == INDEX_NONE) return false;
+	if (!CompiledFilters.IsCompiled()) CompileFilters();
+	return CompiledFilters.UsesPeripheryTypes(FilterIndex);
+}
+
+
+void UPeripheryConfig::CompileFilters() const
+{
+	TArray<const FPeripheryFilter*, TInlineAllocator<FPeripheryCompiledFilters::MaxFilters>> Filters;
+	for (uint8 Kind = 0; Kind < (uint8)EPeripheryKind::EPK_RadiusRing; Kind++)
+	{
+		Filters.Add(GetFilter((EPeripheryKind)Kind));
+	}
+
+	// The radius rings are compiled after the periphery kinds, as long as there's room for them
+	for (int32 RingIndex = 0; RingIndex < RadiusRings.Num(); RingIndex++)
+	{
+		if (GetFilterIndex(EPeripheryKind::EPK_RadiusRing, RingIndex) == INDEX_NONE)
+		{
+			UE_LOGFMT(PeripheryLog, Warning, "{0}: Only the first {1} radius rings have filters, the other rings only use IsValidObjectInRadiusRing()", *GetNameSafe(this), RingIndex);
+			break;
+		}
+
+		Filters.Add(&RadiusRings[RingIndex].Filter);
+	}
+
+	CompiledFilters.Compile(Filters);
+}
+
+
+int32 UPeripheryConfig::GetFilterIndex(const EPeripheryKind Kind, const int32 RingIndex)
+{
+	if (Kind != EPeripheryKind::EPK_RadiusRing) return (int32)Kind;
+
+	const int32 FilterIndex = (int32)EPeripheryKind::EPK_RadiusRing + RingIndex;
+	return RingIndex >= 0 && FilterIndex < FPeripheryCompiledFilters::MaxFilters ? FilterIndex : INDEX_NONE;
+}
@@ -0,0 +1,71 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryEventChannel.h"
+
+
+FPeripheryEventChannel::FPeripheryEventChannel(const uint32 Capacity)
+{
+	const uint32 SlotCount = FMath::RoundUpToPowerOfTwo(FMath::Max<uint32>(Capacity, 2));
+	Mask = SlotCount - 1;
+	Slots = MakeUnique<FSlot[]>(SlotCount);
+	for (uint32 Index = 0; Index < SlotCount; Index++)
+	{
+		Slots[Index].Sequence.store(Index, std::memory_order_relaxed);
+	}
+}
+
+
+bool FPeripheryEventChannel::Publish(const FPeripheryEventRecord& Record)
+{
+	uint64 Position = EnqueuePosition.load(std::memory_order_relaxed);
+	FSlot* Slot;
+	for (;;)
+	{
+		Slot = &Slots[Position & Mask];
+		const uint64 Sequence = Slot->Sequence.load(std::memory_order_acquire);
+		const int64 Difference = (int64)Sequence - (int64)Position;
+
+		// The slot is free, try to claim it
+		if (Difference == 0)
+		{
+			if (EnqueuePosition.compare_exchange_weak(Position, Position + 1, std::memory_order_relaxed)) break;
+		}
+		// The slot hasn't been consumed yet, so the channel is full
+		else if (Difference < 0)
+		{
+			NumDropped.fetch_add(1, std::memory_order_relaxed);
+			return false;
+		}
+		// Another publisher claimed the slot first
+		else
+		{
+			Position = EnqueuePosition.load(std::memory_order_relaxed);
+		}
+	}
+
+	Slot->Record = Record;
+	Slot->Sequence.store(Position + 1, std::memory_order_release);
+
+	// Keep track of the most events the channel has held. The consumer can already be past this event, so the depth is clamped at zero
+	const int64 Depth = FMath::Clamp<int64>((int64)(Position + 1) - (int64)DequeuePosition.load(std::memory_order_relaxed), 0, (int64)Mask + 1);
+	uint32 Previous = HighWaterMark.load(std::memory_order_relaxed);
+	while ((uint32)Depth > Previous && !HighWaterMark.compare_exchange_weak(Previous, (uint32)Depth, std::memory_order_relaxed)) {}
+	return true;
+}
+
+
+bool FPeripheryEventChannel::Consume(FPeripheryEventRecord& OutRecord)
+{
+	const uint64 Position = DequeuePosition.load(std::memory_order_relaxed);
+	FSlot& Slot = Slots[Position & Mask];
+	const uint64 Sequence = Slot.Sequence.load(std::memory_order_acquire);
+	if ((int64)Sequence - (int64)(Position + 1) < 0) return false;
+
+	OutRecord = Slot.Record;
+	DequeuePosition.store(Position + 1, std::memory_order_relaxed);
+
+	// Free the slot for the publishers once they've gone around the channel
+	Slot.Sequence.store(Position + Mask + 1, std::memory_order_release);
+	return true;
+}
@@ -0,0 +1,82 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryFilter.h"
+
+#include "GameplayTagAssetInterface.h"
+#include "PeripheryObjectInterface.h"
+
+
+void FPeripheryCompiledFilters::Compile(const TConstArrayView<const FPeripheryFilter*> InFilters)
+{
+	check(InFilters.Num() <= MaxFilters);
+	Filters = InFilters;
+	ClassMasks.Reset();
+	TypeFilterMask = 0;
+	TagFilterMask = 0;
+
+	constexpr int32 AllPeripheryTypes = (1 << ((int32)EPeripheryType::EPT_Object + 1)) - 1;
+	for (int32 FilterIndex = 0; FilterIndex < Filters.Num(); FilterIndex++)
+	{
+		const FPeripheryFilter* Filter = Filters[FilterIndex];
+		if (!Filter) continue;
+
+		if ((Filter->ValidPeripheryTypes & AllPeripheryTypes) != AllPeripheryTypes) TypeFilterMask |= 1u << FilterIndex;
+		if (!Filter->RequiredTags.IsEmpty() || !Filter->BlockedTags.IsEmpty() || !Filter->TagQuery.IsEmpty()) TagFilterMask |= 1u << FilterIndex;
+	}
+
+	bCompiled = true;
+}
+
+
+bool FPeripheryCompiledFilters::Passes(const int32 FilterIndex, const AActor* Actor, const EPeripheryType PeripheryType) const
+{
+	if (!Actor || !Filters.IsValidIndex(FilterIndex) || !Filters[FilterIndex]) return false;
+
+	const uint32 FilterBit = 1u << FilterIndex;
+	if (!(GetClassMask(Actor->GetClass()) & FilterBit)) return false;
+
+	const FPeripheryFilter& Filter = *Filters[FilterIndex];
+	if ((TypeFilterMask & FilterBit) && !(Filter.ValidPeripheryTypes & (1 << (int32)PeripheryType))) return false;
+
+	if (TagFilterMask & FilterBit)
+	{
+		FGameplayTagContainer Tags;
+		if (const IGameplayTagAssetInterface* TagInterface = Cast<IGameplayTagAssetInterface>(Actor)) TagInterface->GetOwnedGameplayTags(Tags);
+
+		if (!Tags.HasAll(Filter.RequiredTags)) return false;
+		if (Tags.HasAny(Filter.BlockedTags)) return false;
+		if (!Filter.TagQuery.IsEmpty() && !Filter.TagQuery.Matches(Tags)) return false;
+	}
+
+	return true;
+}
+
+
+uint32 FPeripheryCompiledFilters::GetClassMask(const UClass* Class) const
+{
+	if (const uint32* ClassMask = ClassMasks.Find(Class)) return *ClassMask;
+
+	uint32 ClassMask = 0;
+	const bool bPeripheryInterface = Class->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
+	for (int32 FilterIndex = 0; FilterIndex < Filters.Num(); FilterIndex++)
+	{
+		const FPeripheryFilter* Filter = Filters[FilterIndex];
+		if (!Filter) continue;
+		if (Filter->bRequirePeripheryInterface && !bPeripheryInterface) continue;
+
+		bool bValidClass = Filter->ValidClasses.IsEmpty();
+		for (const TSubclassOf<AActor>& ValidClass : Filter->ValidClasses)
+		{
+			if (ValidClass && Class->IsChildOf(ValidClass))
+			{
+				bValidClass = true;
+				break;
+			}
+		}
+
+		if (bValidClass) ClassMask |= 1u << FilterIndex;
+	}
+
+	return ClassMasks.Add(Class, ClassMask);
+}
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryHighlightSubsystem.h"
+
+#include "PlayerPeripheriesComponent.h"
+#include "Components/MeshComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+
+
+static FAutoConsoleCommandWithWorldAndArgs PeripheryHighlightStatsCommand(
+	TEXT("Periphery.Highlight.Stats"),
+	TEXT("Logs the number of periphery highlight changes since the stats were reset. Periphery.Highlight.Stats [Reset]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UPeripheryHighlightSubsystem* HighlightSubsystem = World ? World->GetSubsystem<UPeripheryHighlightSubsystem>() : nullptr;
+		if (!HighlightSubsystem) return;
+
+		const FPeripheryHighlightStats Stats = HighlightSubsystem->GetStats();
+		UE_LOGFMT(PeripheryLog, Log, "Periphery highlights: {0} requests, {1} state changes, {2} skipped changes, {3} component updates",
+			Stats.NumRequests, Stats.NumStateChanges, Stats.NumSkippedChanges, Stats.NumComponentUpdates);
+
+		if (Args.Num() && Args[0] == TEXT("Reset")) HighlightSubsystem->ResetStats();
+	})
+);
+
+
+bool UPeripheryHighlightSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Dedicated servers don't render anything
+	return !IsRunningDedicatedServer() && Super::ShouldCreateSubsystem(Outer);
+}
+
+
+void UPeripheryHighlightSubsystem::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	ApplyHighlights();
+}
+
+
+TStatId UPeripheryHighlightSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPeripheryHighlightSubsystem, STATGROUP_Tickables);
+}
+
+
+void UPeripheryHighlightSubsystem::SetHighlight(AActor* Target, const UObject* Observer, const int32 Source, const bool bHighlight, const int32 StencilValue)
+{
+	if (!Target) return;
+	Stats.NumRequests++;
+
+	const FObjectKey TargetKey(Target);
+	const TPair<FObjectKey, int32> RequestKey(FObjectKey(Observer), Source);
+	if (bHighlight)
+	{
+		FHighlightState& State = Highlights.FindOrAdd(TargetKey);
+		State.Target = Target;
+
+		// Repeated requests don't change anything
+		int32* Request = State.Requests.Find(RequestKey);
+		if (Request && *Request == StencilValue) return;
+
+		State.Requests.Add(RequestKey, StencilValue);
+		DirtyTargets.Add(TargetKey);
+	}
+	else
+	{
+		FHighlightState* State = Highlights.Find(TargetKey);
+		if (!State || !State->Requests.Remove(RequestKey)) return;
+		DirtyTargets.Add(TargetKey);
+	}
+}
+
+
+void UPeripheryHighlightSubsystem::ClearObserver(const UObject* Observer)
+{
+	const FObjectKey ObserverKey(Observer);
+	for (TPair<FObjectKey, FHighlightState>& Highlight : Highlights)
+	{
+		for (auto It = Highlight.Value.Requests.CreateIterator(); It; ++It)
+		{
+			if (It->Key.Key != ObserverKey) continue;
+			It.RemoveCurrent();
+			DirtyTargets.Add(Highlight.Key);
+		}
+	}
+}
+
+
+void UPeripheryHighlightSubsystem::ApplyHighlights()
+{
+	if (DirtyTargets.IsEmpty()) return;
+
+	for (const FObjectKey& TargetKey : DirtyTargets)
+	{
+		FHighlightState* State = Highlights.Find(TargetKey);
+		if (!State) continue;
+
+		AActor* Target = State->Target.Get();
+		if (!Target)
+		{
+			Highlights.Remove(TargetKey);
+			continue;
+		}
+
+		// The highest stencil value of every request is used
+		const bool bHighlight = !State->Requests.IsEmpty();
+		int32 StencilValue = 0;
+		for (const TPair<TPair<FObjectKey, int32>, int32>& Request : State->Requests) StencilValue = FMath::Max(StencilValue, Request.Value);
+
+		// Changes that cancelled each other out during the frame don't need to be applied
+		if (bHighlight == State->bApplied && (!bHighlight || StencilValue == State->AppliedStencilValue))
+		{
+			Stats.NumSkippedChanges++;
+		}
+		else
+		{
+			Stats.NumComponentUpdates += ApplyHighlight(Target, bHighlight, StencilValue);
+			Stats.NumStateChanges++;
+			State->bApplied = bHighlight;
+			State->AppliedStencilValue = bHighlight ? StencilValue : 0;
+		}
+
+		if (!State->bApplied && State->Requests.IsEmpty()) Highlights.Remove(TargetKey);
+	}
+
+	DirtyTargets.Reset();
+}
+
+
+bool UPeripheryHighlightSubsystem::IsHighlighted(const AActor* Target) const
+{
+	const FHighlightState* State = Highlights.Find(FObjectKey(Target));
+	return State && State->bApplied;
+}
+
+
+int32 UPeripheryHighlightSubsystem::GetNumHighlightRequests(const AActor* Target) const
+{
+	const FHighlightState* State = Highlights.Find(FObjectKey(Target));
+	return State ? State->Requests.Num() : 0;
+}
+
+
+int32 UPeripheryHighlightSubsystem::ApplyHighlight(AActor* Target, const bool bHighlight, const int32 StencilValue)
+{
+	int32 NumComponentUpdates = 0;
+	Target->ForEachComponent<UMeshComponent>(false, [&](UMeshComponent* Mesh)
+	{
+		bool bUpdated = false;
+		if (Mesh->bRenderCustomDepth != bHighlight)
+		{
+			Mesh->SetRenderCustomDepth(bHighlight);
+			bUpdated = true;
+		}
+		if (bHighlight && Mesh->CustomDepthStencilValue != StencilValue)
+		{
+			Mesh->SetCustomDepthStencilValue(StencilValue);
+			bUpdated = true;
+		}
+		if (bUpdated) NumComponentUpdates++;
+	});
+
+	return NumComponentUpdates;
+}
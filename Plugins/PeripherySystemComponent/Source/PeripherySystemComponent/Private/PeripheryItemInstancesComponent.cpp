@@ -0,0 +1,143 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryItemInstancesComponent.h"
+
+#include "PlayerPeripheriesComponent.h"
+#include "Logging/StructuredLog.h"
+
+/** The largest item id, item ids are stored as floats so they need to be exactly representable */
+static constexpr int32 MaxPeripheryItemId = 16777215;
+
+
+FPeripheryItemInstance FPeripheryItemInstance::Find(const UPrimitiveComponent* Component, const int32 InstanceIndex)
+{
+	FPeripheryItemInstance Instance;
+	const UPeripheryItemInstancesComponent* ItemInstances = Cast<UPeripheryItemInstancesComponent>(Component);
+	if (!ItemInstances || !ItemInstances->IsValidInstance(InstanceIndex)) return Instance;
+
+	Instance.Component = const_cast<UPeripheryItemInstancesComponent*>(ItemInstances);
+	Instance.InstanceIndex = InstanceIndex;
+	Instance.ItemId = ItemInstances->GetItemId(InstanceIndex);
+
+	// Instances without an item id aren't items
+	if (Instance.ItemId == INDEX_NONE) return FPeripheryItemInstance();
+	return Instance;
+}
+
+
+UPeripheryItemInstancesComponent::UPeripheryItemInstancesComponent(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	ItemIdCustomDataIndex = 0;
+	NumCustomDataFloats = 1;
+	SetGenerateOverlapEvents(true);
+}
+
+
+void UPeripheryItemInstancesComponent::OnRegister()
+{
+	InitItemIdCustomData();
+	Super::OnRegister();
+}
+
+
+void UPeripheryItemInstancesComponent::PostLoad()
+{
+	Super::PostLoad();
+	InitItemIdCustomData();
+}
+
+
+int32 UPeripheryItemInstancesComponent::AddInstance(const FTransform& InstanceTransform, const bool bWorldSpace)
+{
+	// The instance doesn't have an item id until AddItemInstance() sets it, instead of using the default custom data (which would be item 0)
+	const int32 InstanceIndex = Super::AddInstance(InstanceTransform, bWorldSpace);
+	if (InstanceIndex != INDEX_NONE && NumCustomDataFloats > ItemIdCustomDataIndex) SetCustomDataValue(InstanceIndex, ItemIdCustomDataIndex, (float)INDEX_NONE);
+	return InstanceIndex;
+}
+
+
+TArray<int32> UPeripheryItemInstancesComponent::AddInstances(const TArray<FTransform>& InstanceTransforms, const bool bShouldReturnIndices, const bool bWorldSpace)
+{
+	// The new instances are always at the end, so they're found from the instance count instead of the returned indices
+	const int32 FirstInstance = GetInstanceCount();
+	TArray<int32> InstanceIndices = Super::AddInstances(InstanceTransforms, bShouldReturnIndices, bWorldSpace);
+	if (NumCustomDataFloats > ItemIdCustomDataIndex)
+	{
+		for (int32 InstanceIndex = FirstInstance; InstanceIndex < GetInstanceCount(); InstanceIndex++)
+		{
+			SetCustomDataValue(InstanceIndex, ItemIdCustomDataIndex, (float)INDEX_NONE);
+		}
+	}
+	return InstanceIndices;
+}
+
+
+int32 UPeripheryItemInstancesComponent::AddItemInstance(const FTransform& InstanceTransform, const int32 ItemId, const bool bWorldSpace)
+{
+	if (ItemId < 0 || ItemId > MaxPeripheryItemId)
+	{
+		UE_LOGFMT(PeripheryLog, Warning, "{0}: Item id {1} isn't valid, item ids need to be between 0 and {2}", *GetPathNameSafe(this), ItemId, MaxPeripheryItemId);
+		return INDEX_NONE;
+	}
+
+	if (FindItemInstance(ItemId) != INDEX_NONE)
+	{
+		UE_LOGFMT(PeripheryLog, Warning, "{0}: Item id {1} already has an instance, each item can only have one instance", *GetPathNameSafe(this), ItemId);
+		return INDEX_NONE;
+	}
+
+	InitItemIdCustomData();
+	const int32 InstanceIndex = AddInstance(InstanceTransform, bWorldSpace);
+	if (InstanceIndex != INDEX_NONE) SetCustomDataValue(InstanceIndex, ItemIdCustomDataIndex, (float)ItemId, true);
+	return InstanceIndex;
+}
+
+
+bool UPeripheryItemInstancesComponent::RemoveItemInstance(const int32 ItemId)
+{
+	const int32 InstanceIndex = FindItemInstance(ItemId);
+	if (InstanceIndex == INDEX_NONE) return false;
+
+	const int32 LastIndex = GetInstanceCount() - 1;
+	if (!RemoveInstance(InstanceIndex)) return false;
+
+	OnItemInstanceRemoved.Broadcast(this, ItemId, InstanceIndex, InstanceIndex != LastIndex ? LastIndex : INDEX_NONE);
+	return true;
+}
+
+
+int32 UPeripheryItemInstancesComponent::GetItemId(const int32 InstanceIndex) const
+{
+	if (!IsValidInstance(InstanceIndex) || NumCustomDataFloats <= ItemIdCustomDataIndex) return INDEX_NONE;
+	return FMath::RoundToInt(PerInstanceSMCustomData[InstanceIndex * NumCustomDataFloats + ItemIdCustomDataIndex]);
+}
+
+
+int32 UPeripheryItemInstancesComponent::FindItemInstance(const int32 ItemId) const
+{
+	if (ItemId == INDEX_NONE) return INDEX_NONE;
+	for (int32 InstanceIndex = 0; InstanceIndex < GetInstanceCount(); InstanceIndex++)
+	{
+		if (GetItemId(InstanceIndex) == ItemId) return InstanceIndex;
+	}
+	return INDEX_NONE;
+}
+
+
+void UPeripheryItemInstancesComponent::InitItemIdCustomData()
+{
+	if (NumCustomDataFloats > ItemIdCustomDataIndex) return;
+
+	// Resizing the custom data clears it, so any existing instances are marked as not having an item id
+	if (GetInstanceCount() > 0)
+	{
+		UE_LOGFMT(PeripheryLog, Warning, "{0}: The component's custom data didn't have room for the item ids, the existing {1} instances don't have item ids", *GetPathNameSafe(this), GetInstanceCount());
+	}
+
+	SetNumCustomDataFloats(ItemIdCustomDataIndex + 1);
+	for (int32 InstanceIndex = 0; InstanceIndex < GetInstanceCount(); InstanceIndex++)
+	{
+		SetCustomDataValue(InstanceIndex, ItemIdCustomDataIndex, (float)INDEX_NONE);
+	}
+}
@@ -0,0 +1,241 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryLagCompensation.h"
+
+#include "PeripheryConfig.h"
+#include "PeripheryDetection.h"
+#include "PeripheryObjectRegistry.h"
+#include "PlayerPeripheriesComponent.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Logging/StructuredLog.h"
+
+
+static TAutoConsoleVariable<float> CVarPeripheryMaxRewindTime(
+	TEXT("Periphery.LagCompensation.MaxRewindTime"),
+	0.4f,
+	TEXT("How far back the server rewinds the periphery objects when validating a client's trace, in seconds. Older claims are checked against the oldest bounds")
+);
+
+static TAutoConsoleVariable<float> CVarPeripherySnapshotInterval(
+	TEXT("Periphery.LagCompensation.SnapshotInterval"),
+	1.0f / 60.0f,
+	TEXT("How often the bounds of the periphery objects are added to the history, in seconds")
+);
+
+static TAutoConsoleVariable<float> CVarPeripheryClaimTolerance(
+	TEXT("Periphery.LagCompensation.Tolerance"),
+	20.0f,
+	TEXT("How far the bounds of the objects are expanded when validating a client's trace, for the differences between the client's and the server's movement")
+);
+
+static TAutoConsoleVariable<float> CVarPeripheryMaxOriginDistance(
+	TEXT("Periphery.LagCompensation.MaxOriginDistance"),
+	600.0f,
+	TEXT("How far a client's trace can start from it's owner, which needs to cover the distance to the camera")
+);
+
+static TAutoConsoleVariable<bool> CVarPeripheryOcclusionTrace(
+	TEXT("Periphery.LagCompensation.OcclusionTrace"),
+	false,
+	TEXT("Whether claims that reach their target's bounds also trace the world up to the target, so clients can't interact with things through walls. This uses the trace's object types from the owner's config")
+);
+
+/** The most snapshots in the history. The history covers the max rewind time as long as the snapshot interval isn't too short */
+static constexpr int32 MaxPeripherySnapshots = 64;
+
+
+void UPeripheryLagCompensation::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Only servers validate claims, and the history isn't needed until a client has submitted one
+	const UWorld* World = GetWorld();
+	if (!World || !bRecordingHistory) return;
+	if (World->GetNetMode() != NM_DedicatedServer && World->GetNetMode() != NM_ListenServer) return;
+
+	const double Time = World->GetTimeSeconds();
+	if (NumSnapshots == 0 || Time - GetSnapshot(NumSnapshots - 1).Time >= CVarPeripherySnapshotInterval.GetValueOnGameThread())
+	{
+		RecordSnapshot(Time);
+	}
+
+	ValidatePendingClaims();
+}
+
+
+TStatId UPeripheryLagCompensation::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPeripheryLagCompensation, STATGROUP_Tickables);
+}
+
+
+void UPeripheryLagCompensation::SubmitTraceClaim(AActor* Sender, const FPeripheryTraceClaim& Claim, const FOnPeripheryTraceClaimValidated OnValidated)
+{
+	// Only servers validate the queued claims, so anywhere else they'd never be validated
+	const UWorld* World = GetWorld();
+	if (!World || (World->GetNetMode() != NM_DedicatedServer && World->GetNetMode() != NM_ListenServer))
+	{
+		UE_LOGFMT(PeripheryLog, Warning, "{0}: A trace claim was submitted by {1} without being the server, claims are only validated on the server", *GetNameSafe(this), *GetNameSafe(Sender));
+		NumRejectedClaims++;
+		OnValidated.ExecuteIfBound(Claim, false);
+		return;
+	}
+
+	// The owner the client sent isn't trusted, the claim is from whoever sent the rpc
+	FPeripheryTraceClaim& PendingClaim = PendingClaims.Emplace_GetRef(Claim, OnValidated).Key;
+	const APlayerController* PlayerController = Cast<APlayerController>(Sender);
+	PendingClaim.Owner = PlayerController ? PlayerController->GetPawn() : Sender;
+	bRecordingHistory = true;
+}
+
+
+bool UPeripheryLagCompensation::ValidateTraceClaim(const FPeripheryTraceClaim& Claim) const
+{
+	const UWorld* World = GetWorld();
+	const UPeripheryObjectRegistry* Registry = World ? World->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	if (!Registry || !Claim.Owner || !Claim.Target || Claim.Direction.IsNearlyZero()) return false;
+
+	// Claims can't be from the future, or older than the history
+	const double Now = World->GetTimeSeconds();
+	const double Time = FMath::Clamp(Claim.Timestamp, Now - CVarPeripheryMaxRewindTime.GetValueOnGameThread(), Now);
+
+	// The trace needs to start near where the owner was
+	FVector3f OwnerMin, OwnerMax;
+	const FVector OwnerLocation = GetRewoundBounds(Registry->FindHandle(Claim.Owner), Time, OwnerMin, OwnerMax)
+		? FVector(OwnerMin + OwnerMax) * 0.5
+		: Claim.Owner->GetActorLocation();
+	if (FVector::DistSquared(Claim.Origin, OwnerLocation) > FMath::Square(CVarPeripheryMaxOriginDistance.GetValueOnGameThread())) return false;
+
+	// The trace needs to reach the target where it was when the client traced it
+	FVector3f TargetMin, TargetMax;
+	if (!GetRewoundBounds(Registry->FindHandle(Claim.Target), Time, TargetMin, TargetMax)) return false;
+
+	const UPlayerPeripheriesComponent* PeripheryComponent = Claim.Owner->FindComponentByClass<UPlayerPeripheriesComponent>();
+	const UPeripheryConfig* Config = PeripheryComponent ? PeripheryComponent->GetPeripheryConfig() : GetDefault<UPeripheryConfig>();
+	const FVector Tolerance(CVarPeripheryClaimTolerance.GetValueOnGameThread());
+	const FVector Direction = Claim.Direction.GetSafeNormal();
+	double Distance;
+	if (!PeripheryDetection::IntersectRayBox(
+		Claim.Origin, PeripheryDetection::GetInverseDirection(Direction),
+		FVector(TargetMin) - Tolerance, FVector(TargetMax) + Tolerance, Config->PeripheryTraceDistance, Distance
+	)) return false;
+
+	// Optionally check that nothing else was in the way, up to where the trace reached the target
+	if (!CVarPeripheryOcclusionTrace.GetValueOnGameThread() || Config->PeripheryLineTraceObjectTypes.IsEmpty()) return true;
+
+	FHitResult Hit;
+	const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PeripheryLagCompensation), false, Claim.Owner);
+	const bool bHit = World->LineTraceSingleByObjectType(Hit, Claim.Origin, Claim.Origin + Direction * Distance, FCollisionObjectQueryParams(Config->PeripheryLineTraceObjectTypes), QueryParams);
+	return !bHit || Hit.GetActor() == Claim.Target;
+}
+
+
+bool UPeripheryLagCompensation::GetRewoundBounds(const FPeripheryHandle& Handle, const double Time, FVector3f& OutMin, FVector3f& OutMax) const
+{
+	if (!Handle.IsSet() || NumSnapshots == 0) return false;
+
+	// The first snapshot that's after the time
+	int32 Low = 0;
+	int32 High = NumSnapshots;
+	while (Low < High)
+	{
+		const int32 Middle = (Low + High) / 2;
+		if (GetSnapshot(Middle).Time <= Time) Low = Middle + 1;
+		else High = Middle;
+	}
+
+	auto FindBounds = [&Handle](const FBoundsSnapshot& Snapshot, FVector3f& Min, FVector3f& Max)
+	{
+		if (!Snapshot.Generations.IsValidIndex(Handle.Index) || Snapshot.Generations[Handle.Index] != Handle.Generation) return false;
+		Min = Snapshot.BoundsMin[Handle.Index];
+		Max = Snapshot.BoundsMax[Handle.Index];
+		return true;
+	};
+
+	// Use the snapshots on either side of the time, or the closest one if the object wasn't in both of them
+	FVector3f BeforeMin, BeforeMax, AfterMin, AfterMax;
+	const bool bBefore = Low > 0 && FindBounds(GetSnapshot(Low - 1), BeforeMin, BeforeMax);
+	const bool bAfter = Low < NumSnapshots && FindBounds(GetSnapshot(Low), AfterMin, AfterMax);
+	if (bBefore && bAfter)
+	{
+		const double BeforeTime = GetSnapshot(Low - 1).Time;
+		const double AfterTime = GetSnapshot(Low).Time;
+		const float Alpha = AfterTime > BeforeTime ? (float)((Time - BeforeTime) / (AfterTime - BeforeTime)) : 0.0f;
+		OutMin = FMath::Lerp(BeforeMin, AfterMin, Alpha);
+		OutMax = FMath::Lerp(BeforeMax, AfterMax, Alpha);
+		return true;
+	}
+	if (bBefore)
+	{
+		OutMin = BeforeMin;
+		OutMax = BeforeMax;
+		return true;
+	}
+	if (bAfter)
+	{
+		OutMin = AfterMin;
+		OutMax = AfterMax;
+		return true;
+	}
+	return false;
+}
+
+
+void UPeripheryLagCompensation::RecordSnapshot(const double Time)
+{
+	const UPeripheryObjectRegistry* Registry = GetWorld()->GetSubsystem<UPeripheryObjectRegistry>();
+	if (!Registry) return;
+
+	// Reuse the oldest snapshot once the history is full
+	if (Snapshots.Num() < MaxPeripherySnapshots) Snapshots.AddDefaulted();
+	NewestSnapshot = (NewestSnapshot + 1) % Snapshots.Num();
+	NumSnapshots = FMath::Min(NumSnapshots + 1, Snapshots.Num());
+
+	const TConstArrayView<FPeripheryHandle> Handles = Registry->GetHandles();
+	const TConstArrayView<FVector3f> BoundsMin = Registry->GetBoundsMin();
+	const TConstArrayView<FVector3f> BoundsMax = Registry->GetBoundsMax();
+	int32 NumSlots = 0;
+	for (const FPeripheryHandle& Handle : Handles) NumSlots = FMath::Max(NumSlots, (int32)Handle.Index + 1);
+
+	FBoundsSnapshot& Snapshot = Snapshots[NewestSnapshot];
+	Snapshot.Time = Time;
+	Snapshot.Generations.Reset();
+	Snapshot.Generations.SetNumZeroed(NumSlots);
+	Snapshot.BoundsMin.SetNumUninitialized(NumSlots);
+	Snapshot.BoundsMax.SetNumUninitialized(NumSlots);
+	for (int32 PackedIndex = 0; PackedIndex < Handles.Num(); PackedIndex++)
+	{
+		const uint32 Slot = Handles[PackedIndex].Index;
+		Snapshot.Generations[Slot] = Handles[PackedIndex].Generation;
+		Snapshot.BoundsMin[Slot] = BoundsMin[PackedIndex];
+		Snapshot.BoundsMax[Slot] = BoundsMax[PackedIndex];
+	}
+}
+
+
+void UPeripheryLagCompensation::ValidatePendingClaims()
+{
+	if (PendingClaims.IsEmpty()) return;
+
+	// The delegates can submit new claims, those are validated next frame
+	TArray<TPair<FPeripheryTraceClaim, FOnPeripheryTraceClaimValidated>> Claims = MoveTemp(PendingClaims);
+	PendingClaims.Reset();
+	for (const TPair<FPeripheryTraceClaim, FOnPeripheryTraceClaimValidated>& Claim : Claims)
+	{
+		const bool bValid = ValidateTraceClaim(Claim.Key);
+		if (bValid) NumValidClaims++;
+		else NumRejectedClaims++;
+
+		Claim.Value.ExecuteIfBound(Claim.Key, bValid);
+	}
+}
+
+
+const UPeripheryLagCompensation::FBoundsSnapshot& UPeripheryLagCompensation::GetSnapshot(const int32 HistoryIndex) const
+{
+	const int32 OldestSnapshot = (NewestSnapshot - NumSnapshots + 1 + Snapshots.Num()) % Snapshots.Num();
+	return Snapshots[(OldestSnapshot + HistoryIndex) % Snapshots.Num()];
+}
@@ -3,6 +3,11 @@
 
 #include "PeripheryObjectInterface.h"
 
+EPeripheryType IPeripheryObjectInterface::GetPeripheryType_Implementation() const
+{
+	return EPeripheryType::EPT_Object;
+}
+
 void IPeripheryObjectInterface::WithinPlayerRadiusPeriphery_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType)
 {
 }
@@ -11,6 +16,14 @@ void IPeripheryObjectInterface::OutsideOfPlayerRadiusPeriphery_Implementation(AA
 {
 }
 
+void IPeripheryObjectInterface::WithinPlayerRadiusRing_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType, int32 RingIndex, FName RingName)
+{
+}
+
+void IPeripheryObjectInterface::OutsideOfPlayerRadiusRing_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType, int32 RingIndex, FName RingName)
+{
+}
+
 void IPeripheryObjectInterface::WithinPlayer_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType)
 {
 }
@@ -26,3 +39,11 @@ void IPeripheryObjectInterface::WithinPlayerTracePeriphery_Implementation(AActor
 void IPeripheryObjectInterface::OutsideOfPlayerTracePeriphery_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType)
 {
 }
+
+void IPeripheryObjectInterface::WithinPlayerItemInstance_Implementation(AActor* SourceCharacter, const FPeripheryItemInstance& Instance, EPeripheryKind PeripheryKind)
+{
+}
+
+void IPeripheryObjectInterface::OutsideOfPlayerItemInstance_Implementation(AActor* SourceCharacter, const FPeripheryItemInstance& Instance, EPeripheryKind PeripheryKind)
+{
+}
@@ -0,0 +1,459 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryObjectRegistry.h"
+
+#include "GenericTeamAgentInterface.h"
+#include "PeripheryDetection.h"
+#include "PeripheryObjectInterface.h"
+#include "PeripheryStaticIndex.h"
+#include "PlayerPeripheriesComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Logging/StructuredLog.h"
+
+
+bool UPeripheryObjectRegistry::DoesSupportWorldType(const EWorldType::Type WorldType) const
+{
+	return WorldType == EWorldType::Game || WorldType == EWorldType::PIE;
+}
+
+
+void UPeripheryObjectRegistry::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+	ActorSpawnedDelegate = GetWorld()->AddOnActorSpawnedHandler(FOnActorSpawned::FDelegate::CreateUObject(this, &UPeripheryObjectRegistry::OnActorSpawned));
+	ActorDestroyedDelegate = GetWorld()->AddOnActorDestroyedHandler(FOnActorDestroyed::FDelegate::CreateUObject(this, &UPeripheryObjectRegistry::OnActorDestroyed));
+	LevelAddedDelegate = FWorldDelegates::LevelAddedToWorld.AddUObject(this, &UPeripheryObjectRegistry::OnLevelAddedToWorld);
+	LevelRemovedDelegate = FWorldDelegates::LevelRemovedFromWorld.AddUObject(this, &UPeripheryObjectRegistry::OnLevelRemovedFromWorld);
+}
+
+
+void UPeripheryObjectRegistry::OnWorldBeginPlay(UWorld& InWorld)
+{
+	Super::OnWorldBeginPlay(InWorld);
+
+	// The static indexes have already added themselves, and the periphery objects that were placed in the levels are registered once they've begun play
+	for (ULevel* Level : InWorld.GetLevels())
+	{
+		if (Level) RegisterLevelObjects(*Level);
+	}
+}
+
+
+void UPeripheryObjectRegistry::Deinitialize()
+{
+	if (UWorld* World = GetWorld())
+	{
+		World->RemoveOnActorSpawnedHandler(ActorSpawnedDelegate);
+		World->RemoveOnActorDestroyedHandler(ActorDestroyedDelegate);
+	}
+	FWorldDelegates::LevelAddedToWorld.Remove(LevelAddedDelegate);
+	FWorldDelegates::LevelRemovedFromWorld.Remove(LevelRemovedDelegate);
+
+	for (int32 PackedIndex = 0; PackedIndex < Actors.Num(); PackedIndex++)
+	{
+		AActor* Actor = Actors[PackedIndex].Get();
+		if (!Actor) continue;
+
+		Actor->OnEndPlay.RemoveDynamic(this, &UPeripheryObjectRegistry::OnActorEndPlay);
+		if (USceneComponent* RootComponent = Actor->GetRootComponent()) RootComponent->TransformUpdated.Remove(TransformDelegates[PackedIndex]);
+	}
+
+	PendingActors.Empty();
+	LevelIndexes.Empty();
+	Super::Deinitialize();
+}
+
+
+void UPeripheryObjectRegistry::Tick(const float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+	if (!PendingActors.IsEmpty()) RegisterPendingActors();
+}
+
+
+TStatId UPeripheryObjectRegistry::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UPeripheryObjectRegistry, STATGROUP_Tickables);
+}
+
+
+void UPeripheryObjectRegistry::RegisterPendingActors()
+{
+	for (int32 PendingIndex = PendingActors.Num() - 1; PendingIndex >= 0; PendingIndex--)
+	{
+		AActor* Actor = PendingActors[PendingIndex].Get();
+		if (Actor && !Actor->HasActorBegunPlay()) continue;
+
+		PendingActors.RemoveAtSwap(PendingIndex, 1, false);
+		if (Actor && !Actor->IsActorBeingDestroyed()) RegisterPeripheryObject(Actor);
+	}
+}
+
+
+FPeripheryHandle UPeripheryObjectRegistry::RegisterPeripheryObject(AActor* Actor)
+{
+	if (!Actor) return FPeripheryHandle();
+	if (const FPeripheryHandle* Handle = ActorHandles.Find(Actor)) return *Handle;
+
+	const int32 PackedIndex = AddObject(Actor, Actor->GetActorLocation(), CalculateObjectInfo(Actor), false);
+	UpdateTransform(PackedIndex, Actor);
+	return Handles[PackedIndex];
+}
+
+
+void UPeripheryObjectRegistry::UpdatePeripheryObject(AActor* Actor)
+{
+	const int32 PackedIndex = GetPackedIndex(FindHandle(Actor));
+	if (PackedIndex == INDEX_NONE) return;
+
+	const FPeripheryObjectInfo Info = CalculateObjectInfo(Actor);
+	Types[PackedIndex] = Info.Type;
+	Teams[PackedIndex] = Info.Team;
+	Flags[PackedIndex] = Info.Flags;
+	LocalBoundsOffsets[PackedIndex] = Info.LocalBoundsOffset;
+	BoundsRadii[PackedIndex] = Info.BoundsRadius;
+
+	// Objects registered without a root component start tracking their transform once they have one
+	USceneComponent* RootComponent = Actor->GetRootComponent();
+	if (RootComponent && !TransformDelegates[PackedIndex].IsValid())
+	{
+		TransformDelegates[PackedIndex] = RootComponent->TransformUpdated.AddUObject(this, &UPeripheryObjectRegistry::OnTransformUpdated);
+	}
+
+	UpdateTransform(PackedIndex, Actor);
+}
+
+
+void UPeripheryObjectRegistry::AddStaticIndex(const APeripheryStaticIndex& StaticIndex)
+{
+	LevelIndexes.Add(StaticIndex.GetLevel(), &StaticIndex);
+
+	const TConstArrayView<TObjectPtr<AActor>> IndexedActors = StaticIndex.GetActors();
+	const int32 NumObjects = Handles.Num() + IndexedActors.Num();
+	Handles.Reserve(NumObjects);
+	Positions.Reserve(NumObjects);
+	BoundsMin.Reserve(NumObjects);
+	BoundsMax.Reserve(NumObjects);
+	Types.Reserve(NumObjects);
+	Teams.Reserve(NumObjects);
+	Flags.Reserve(NumObjects);
+	LocalBoundsOffsets.Reserve(NumObjects);
+	BoundsRadii.Reserve(NumObjects);
+	Actors.Reserve(NumObjects);
+	TransformDelegates.Reserve(NumObjects);
+	ActorHandles.Reserve(NumObjects);
+
+	// The information was calculated when the index was built, and static objects don't move so their transforms aren't tracked
+	for (int32 IndexedObject = 0; IndexedObject < IndexedActors.Num(); IndexedObject++)
+	{
+		AActor* Actor = IndexedActors[IndexedObject];
+		if (!Actor || ActorHandles.Contains(Actor)) continue;
+
+#if WITH_EDITOR
+		// Objects that moved without the index being rebuilt (with one file per actor) use their actual transform
+		if (StaticIndex.HasMoved(IndexedObject))
+		{
+			UE_LOGFMT(PeripheryLog, Warning, "{0}: {1} has moved since the periphery static index was built, rebuild the index", *GetNameSafe(&StaticIndex), *GetNameSafe(Actor));
+			const int32 PackedIndex = AddObject(Actor, Actor->GetActorLocation(), CalculateObjectInfo(Actor), true);
+			UpdateTransform(PackedIndex, Actor);
+			continue;
+		}
+#endif
+
+		FPeripheryObjectInfo Info;
+		Info.Type = StaticIndex.GetTypes()[IndexedObject];
+		Info.Team = StaticIndex.GetTeams()[IndexedObject];
+		Info.Flags = StaticIndex.GetFlags()[IndexedObject];
+		Info.LocalBoundsOffset = StaticIndex.GetLocalBoundsOffsets()[IndexedObject];
+		Info.BoundsRadius = StaticIndex.GetBoundsRadii()[IndexedObject];
+
+		const int32 PackedIndex = AddObject(Actor, StaticIndex.GetPositions()[IndexedObject], Info, true);
+		BoundsMin[PackedIndex] = StaticIndex.GetBoundsMin()[IndexedObject];
+		BoundsMax[PackedIndex] = StaticIndex.GetBoundsMax()[IndexedObject];
+	}
+}
+
+
+FPeripheryObjectInfo UPeripheryObjectRegistry::CalculateObjectInfo(const AActor* Actor)
+{
+	FPeripheryObjectInfo Info;
+	if (!Actor) return Info;
+
+	const bool bPeripheryInterface = Actor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
+	const IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(Actor);
+	if (bPeripheryInterface) Info.Flags |= EPeripheryObjectFlags::EPO_PeripheryInterface;
+	if (TeamAgent) Info.Flags |= EPeripheryObjectFlags::EPO_TeamAgent;
+	Info.Type = bPeripheryInterface ? IPeripheryObjectInterface::Execute_GetPeripheryType(Actor) : EPeripheryType::EPT_None;
+	Info.Team = TeamAgent ? TeamAgent->GetGenericTeamId().GetId() : FGenericTeamId::NoTeam.GetId();
+
+	FVector Origin, Extent;
+	Actor->GetActorBounds(false, Origin, Extent);
+	Info.LocalBoundsOffset = FVector3f(Actor->GetActorQuat().UnrotateVector(Origin - Actor->GetActorLocation()));
+	Info.BoundsRadius = Extent.Size();
+	return Info;
+}
+
+
+int32 UPeripheryObjectRegistry::AddObject(AActor* Actor, const FVector& Position, const FPeripheryObjectInfo& Info, const bool bStatic)
+{
+	// Find a handle slot
+	uint32 Slot;
+	if (!FreeSlots.IsEmpty())
+	{
+		Slot = FreeSlots.Pop(false);
+	}
+	else
+	{
+		Slot = SlotGenerations.Add(1);
+		SlotToPacked.Add(INDEX_NONE);
+	}
+
+	FPeripheryHandle Handle;
+	Handle.Index = Slot;
+	Handle.Generation = SlotGenerations[Slot];
+
+	// Add the object's information
+	const int32 PackedIndex = Handles.Add(Handle);
+	Positions.Add(Position);
+	BoundsMin.AddDefaulted();
+	BoundsMax.AddDefaulted();
+	Types.Add(Info.Type);
+	Teams.Add(Info.Team);
+	Flags.Add(Info.Flags);
+	LocalBoundsOffsets.Add(Info.LocalBoundsOffset);
+	BoundsRadii.Add(Info.BoundsRadius);
+	Actors.Add(Actor);
+	TransformDelegates.Add(!bStatic && Actor->GetRootComponent()
+		? Actor->GetRootComponent()->TransformUpdated.AddUObject(this, &UPeripheryObjectRegistry::OnTransformUpdated)
+		: FDelegateHandle()
+	);
+
+	SlotToPacked[Slot] = PackedIndex;
+	ActorHandles.Add(Actor, Handle);
+	if (!bStatic) Actor->OnEndPlay.AddUniqueDynamic(this, &UPeripheryObjectRegistry::OnActorEndPlay);
+	return PackedIndex;
+}
+
+
+void UPeripheryObjectRegistry::UnregisterPeripheryObject(AActor* Actor)
+{
+	FPeripheryHandle Handle;
+	if (!Actor || !ActorHandles.RemoveAndCopyValue(Actor, Handle)) return;
+
+	const int32 PackedIndex = GetPackedIndex(Handle);
+	if (PackedIndex == INDEX_NONE) return;
+
+	Actor->OnEndPlay.RemoveDynamic(this, &UPeripheryObjectRegistry::OnActorEndPlay);
+	if (USceneComponent* RootComponent = Actor->GetRootComponent()) RootComponent->TransformUpdated.Remove(TransformDelegates[PackedIndex]);
+
+	// Move the last object into the removed object's place to keep everything packed
+	const int32 LastIndex = Handles.Num() - 1;
+	if (PackedIndex != LastIndex)
+	{
+		SlotToPacked[Handles[LastIndex].Index] = PackedIndex;
+	}
+
+	Handles.RemoveAtSwap(PackedIndex, 1, false);
+	Positions.RemoveAtSwap(PackedIndex, 1, false);
+	BoundsMin.RemoveAtSwap(PackedIndex, 1, false);
+	BoundsMax.RemoveAtSwap(PackedIndex, 1, false);
+	Types.RemoveAtSwap(PackedIndex, 1, false);
+	Teams.RemoveAtSwap(PackedIndex, 1, false);
+	Flags.RemoveAtSwap(PackedIndex, 1, false);
+	LocalBoundsOffsets.RemoveAtSwap(PackedIndex, 1, false);
+	BoundsRadii.RemoveAtSwap(PackedIndex, 1, false);
+	Actors.RemoveAtSwap(PackedIndex, 1, false);
+	TransformDelegates.RemoveAtSwap(PackedIndex, 1, false);
+
+	// Invalidate the handle and free the slot (generation zero is reserved for unset handles)
+	SlotToPacked[Handle.Index] = INDEX_NONE;
+	if (++SlotGenerations[Handle.Index] == 0) SlotGenerations[Handle.Index] = 1;
+	FreeSlots.Add(Handle.Index);
+}
+
+
+FPeripheryHandle UPeripheryObjectRegistry::FindHandle(const AActor* Actor) const
+{
+	const FPeripheryHandle* Handle = Actor ? ActorHandles.Find(Actor) : nullptr;
+	return Handle ? *Handle : FPeripheryHandle();
+}
+
+
+AActor* UPeripheryObjectRegistry::GetActor(const FPeripheryHandle& Handle) const
+{
+	const int32 PackedIndex = GetPackedIndex(Handle);
+	return PackedIndex != INDEX_NONE ? Actors[PackedIndex].Get() : nullptr;
+}
+
+
+bool UPeripheryObjectRegistry::IsValidHandle(const FPeripheryHandle& Handle) const
+{
+	return GetPackedIndex(Handle) != INDEX_NONE;
+}
+
+
+int32 UPeripheryObjectRegistry::GetPackedIndex(const FPeripheryHandle& Handle) const
+{
+	if (!Handle.IsSet() || !SlotGenerations.IsValidIndex(Handle.Index)) return INDEX_NONE;
+	if (SlotGenerations[Handle.Index] != Handle.Generation) return INDEX_NONE;
+	return SlotToPacked[Handle.Index];
+}
+
+
+void UPeripheryObjectRegistry::QuerySphere(const FVector& Center, const float Radius, TArray<FPeripheryHandle>& OutHandles) const
+{
+	const double RadiusSquared = FMath::Square(Radius);
+	for (int32 PackedIndex = 0; PackedIndex < Positions.Num(); PackedIndex++)
+	{
+		if (FVector::DistSquared(Center, Positions[PackedIndex]) <= RadiusSquared)
+		{
+			OutHandles.Add(Handles[PackedIndex]);
+		}
+	}
+}
+
+
+bool UPeripheryObjectRegistry::RaycastBounds(const FVector& Origin, const FVector& Direction, const float MaxDistance, const TConstArrayView<FPeripheryHandle> IgnoredHandles, float& OutNearDistance, float& OutFarDistance) const
+{
+	TArray<int32, TInlineAllocator<8>> IgnoredIndices;
+	for (const FPeripheryHandle& Handle : IgnoredHandles)
+	{
+		const int32 PackedIndex = GetPackedIndex(Handle);
+		if (PackedIndex != INDEX_NONE) IgnoredIndices.Add(PackedIndex);
+	}
+
+
+	const FVector3f InverseDirection = FVector3f(PeripheryDetection::GetInverseDirection(Direction));
+	const VectorRegister4Float RayOrigin = MakeVectorRegisterFloat((float)Origin.X, (float)Origin.Y, (float)Origin.Z, 0.0f);
+	const VectorRegister4Float RayInverseDirection = MakeVectorRegisterFloat(InverseDirection.X, InverseDirection.Y, InverseDirection.Z, 0.0f);
+	const VectorRegister4Float Zero = VectorZeroFloat();
+	const VectorRegister4Float RayMaxDistance = VectorSetFloat1(MaxDistance);
+
+	// Slab test for each of the bounds, every axis is calculated at once and the fourth lane is ignored
+	VectorRegister4Float Nearest = RayMaxDistance;
+	VectorRegister4Float Farthest = Zero;
+	bool bHit = false;
+	for (int32 PackedIndex = 0; PackedIndex < BoundsMin.Num(); PackedIndex++)
+	{
+		if (IgnoredIndices.Num() && IgnoredIndices.Contains(PackedIndex)) continue;
+
+		const VectorRegister4Float T0 = VectorMultiply(VectorSubtract(VectorLoadFloat3(&BoundsMin[PackedIndex].X), RayOrigin), RayInverseDirection);
+		const VectorRegister4Float T1 = VectorMultiply(VectorSubtract(VectorLoadFloat3(&BoundsMax[PackedIndex].X), RayOrigin), RayInverseDirection);
+		const VectorRegister4Float TNear = VectorMin(T0, T1);
+		const VectorRegister4Float TFar = VectorMax(T0, T1);
+
+		// The ray is inside the bounds between the largest entry of the axes and the smallest exit, clamped to the ray's length
+		const VectorRegister4Float Near = VectorMax(VectorMax(VectorReplicate(TNear, 0), VectorReplicate(TNear, 1)), VectorMax(VectorReplicate(TNear, 2), Zero));
+		const VectorRegister4Float Far = VectorMin(VectorMin(VectorReplicate(TFar, 0), VectorReplicate(TFar, 1)), VectorMin(VectorReplicate(TFar, 2), RayMaxDistance));
+		if (VectorAnyGreaterThan(Near, Far)) continue;
+
+		Nearest = VectorMin(Nearest, Near);
+		Farthest = VectorMax(Farthest, Far);
+		bHit = true;
+	}
+
+	VectorStoreFloat1(Nearest, &OutNearDistance);
+	VectorStoreFloat1(Farthest, &OutFarDistance);
+	return bHit;
+}
+
+
+void UPeripheryObjectRegistry::OnActorSpawned(AActor* Actor)
+{
+	if (!Actor || !Actor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass())) return;
+
+	// Spawned actors (especially deferred ones) might not have their root component or team yet, so they're registered once they've begun play
+	if (Actor->HasActorBegunPlay()) RegisterPeripheryObject(Actor);
+	else PendingActors.AddUnique(Actor);
+}
+
+
+void UPeripheryObjectRegistry::OnActorDestroyed(AActor* Actor)
+{
+	// Static objects don't bind their EndPlay, so they're removed here
+	UnregisterPeripheryObject(Actor);
+}
+
+
+void UPeripheryObjectRegistry::OnLevelAddedToWorld(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld() || !World->HasBegunPlay()) return;
+	RegisterLevelObjects(*Level);
+}
+
+
+void UPeripheryObjectRegistry::OnLevelRemovedFromWorld(ULevel* Level, UWorld* World)
+{
+	if (!Level || World != GetWorld()) return;
+
+	// The static objects of the level are removed with it
+	TWeakObjectPtr<const APeripheryStaticIndex> StaticIndex;
+	if (!LevelIndexes.RemoveAndCopyValue(Level, StaticIndex) || !StaticIndex.IsValid()) return;
+	for (AActor* Actor : StaticIndex->GetActors())
+	{
+		UnregisterPeripheryObject(Actor);
+	}
+}
+
+
+void UPeripheryObjectRegistry::RegisterLevelObjects(ULevel& Level)
+{
+	const TWeakObjectPtr<const APeripheryStaticIndex>* StaticIndex = LevelIndexes.Find(&Level);
+	if (StaticIndex && StaticIndex->IsValid())
+	{
+		for (AActor* Actor : (*StaticIndex)->GetDynamicActors())
+		{
+			OnActorSpawned(Actor);
+		}
+		return;
+	}
+
+	// Levels without an index are searched for their periphery objects
+	for (AActor* Actor : Level.Actors)
+	{
+		if (const APeripheryStaticIndex* LevelIndex = Cast<APeripheryStaticIndex>(Actor)) AddStaticIndex(*LevelIndex);
+		else OnActorSpawned(Actor);
+	}
+}
+
+
+void UPeripheryObjectRegistry::OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason)
+{
+	UnregisterPeripheryObject(Actor);
+}
+
+
+void UPeripheryObjectRegistry::OnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport)
+{
+	const AActor* Actor = UpdatedComponent ? UpdatedComponent->GetOwner() : nullptr;
+	const FPeripheryHandle* Handle = Actor ? ActorHandles.Find(Actor) : nullptr;
+	if (!Handle) return;
+
+	const int32 PackedIndex = GetPackedIndex(*Handle);
+	if (PackedIndex != INDEX_NONE) UpdateTransform(PackedIndex, Actor);
+}
+
+
+void UPeripheryObjectRegistry::UpdateTransform(const int32 PackedIndex, const AActor* Actor)
+{
+	Positions[PackedIndex] = Actor->GetActorLocation();
+	CalculateBounds(Actor, LocalBoundsOffsets[PackedIndex], BoundsRadii[PackedIndex], BoundsMin[PackedIndex], BoundsMax[PackedIndex]);
+
+	// Team agents can change teams (like when they're possessed), so their team is refreshed whenever they move
+	if (EnumHasAnyFlags(Flags[PackedIndex], EPeripheryObjectFlags::EPO_TeamAgent))
+	{
+		if (const IGenericTeamAgentInterface* TeamAgent = Cast<IGenericTeamAgentInterface>(Actor)) Teams[PackedIndex] = TeamAgent->GetGenericTeamId().GetId();
+	}
+}
+
+
+void UPeripheryObjectRegistry::CalculateBounds(const AActor* Actor, const FVector3f& LocalBoundsOffset, const float BoundsRadius, FVector3f& OutMin, FVector3f& OutMax)
+{
+	// The bounds are a box around the bounds' sphere, so they don't need to be recalculated when the object rotates
+	const FVector3f Center = FVector3f(Actor->GetActorLocation() + Actor->GetActorQuat().RotateVector(FVector(LocalBoundsOffset)));
+	const FVector3f Extent = FVector3f(BoundsRadius);
+	OutMin = Center - Extent;
+	OutMax = Center + Extent;
+}
@@ -0,0 +1,388 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryRecording.h"
+
+#include "PeripheryDetection.h"
+#include "PlayerPeripheriesComponent.h"
+#include "HAL/FileManager.h"
+#include "HAL/PlatformFileManager.h"
+#include "Async/MappedFileHandle.h"
+#include "Misc/FileHelper.h"
+#include "Logging/StructuredLog.h"
+
+
+#pragma region Recorder
+FPeripheryRecorder::~FPeripheryRecorder()
+{
+	Stop();
+}
+
+
+bool FPeripheryRecorder::Start(const FString& Filename)
+{
+	Stop();
+
+	Writer = TUniquePtr<FArchive>(IFileManager::Get().CreateFileWriter(*Filename));
+	if (!Writer)
+	{
+		UE_LOGFMT(PeripheryLog, Error, "{0}() -> Unable to create the periphery recording {1}", *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	FPeripheryRecordingHeader Header;
+	Writer->Serialize(&Header, sizeof(Header));
+	UE_LOGFMT(PeripheryLog, Log, "Started recording the periphery to {0}", *Filename);
+	return true;
+}
+
+
+void FPeripheryRecorder::Stop()
+{
+	if (!Writer) return;
+
+	FlushFrame();
+	Writer->Close();
+	Writer.Reset();
+
+	ActorIds.Reset();
+	PreviousCandidates.Reset();
+	UE_LOGFMT(PeripheryLog, Log, "Stopped recording the periphery");
+}
+
+
+uint32 FPeripheryRecorder::GetActorId(const AActor* Actor)
+{
+	if (!Actor || !Writer) return 0;
+	if (const uint32* ActorId = ActorIds.Find(Actor)) return *ActorId;
+
+	uint32 ActorId = ActorIds.Num() + 1;
+	ActorIds.Add(Actor, ActorId);
+
+	// Names are padded to keep the records aligned
+	FTCHARToUTF8 Name(*GetNameSafe(Actor));
+	uint32 RecordType = static_cast<uint32>(PeripheryRecording::ERecordType::Name);
+	uint32 NameLength = Name.Length();
+	uint8 Padding[4] = {};
+	Writer->Serialize(&RecordType, sizeof(RecordType));
+	Writer->Serialize(&ActorId, sizeof(ActorId));
+	Writer->Serialize(&NameLength, sizeof(NameLength));
+	Writer->Serialize(const_cast<ANSICHAR*>(Name.Get()), NameLength);
+	Writer->Serialize(Padding, Align(NameLength, 4) - NameLength);
+	return ActorId;
+}
+
+
+void FPeripheryRecorder::RecordOwner(const AActor* OwnerActor, FPeripheryRecordedOwner Owner, const TArray<AActor*>& Candidates, TFunctionRef<uint32(AActor*)> GetCandidateFlags)
+{
+	if (!Writer || !OwnerActor) return;
+
+	// Begin the next frame
+	if (PendingFrameNumber != GFrameCounter)
+	{
+		FlushFrame();
+		PendingFrameNumber = GFrameCounter;
+		PendingTime = OwnerActor->GetWorld() ? OwnerActor->GetWorld()->GetTimeSeconds() : 0;
+	}
+
+	Owner.OwnerId = GetActorId(OwnerActor);
+	Owner.NumEntries = 0;
+
+	// Candidates that were within the owner's periphery last frame are recorded until they've left, so the replay sees them exit
+	TArray<TWeakObjectPtr<const AActor>>& OwnerCandidates = PreviousCandidates.FindOrAdd(Owner.OwnerId);
+	TArray<AActor*, TInlineAllocator<32>> RecordedCandidates;
+	RecordedCandidates.Append(Candidates);
+	for (const TWeakObjectPtr<const AActor>& Previous : OwnerCandidates)
+	{
+		if (AActor* Actor = const_cast<AActor*>(Previous.Get())) RecordedCandidates.AddUnique(Actor);
+	}
+
+	OwnerCandidates.Reset();
+	for (AActor* Candidate : RecordedCandidates)
+	{
+		if (!Candidate || Candidate == OwnerActor) continue;
+
+		FPeripheryRecordedEntry& Entry = PendingEntries.AddDefaulted_GetRef();
+		Entry.CandidateIndex = AddCandidate(Candidate);
+		Entry.Flags = GetCandidateFlags(Candidate);
+		Owner.NumEntries++;
+
+		if (Candidates.Contains(Candidate)) OwnerCandidates.Add(Candidate);
+	}
+
+	PendingOwners.Add(Owner);
+}
+
+
+uint32 FPeripheryRecorder::AddCandidate(const AActor* Actor)
+{
+	const uint32 ActorId = GetActorId(Actor);
+	if (const uint32* Index = PendingCandidateIndices.Find(ActorId)) return *Index;
+
+	FVector BoundsOrigin, BoundsExtent;
+	Actor->GetActorBounds(true, BoundsOrigin, BoundsExtent);
+
+	const uint32 Index = PendingCandidates.Num();
+	PendingCandidates.Add({ActorId, FVector3f(BoundsOrigin), FVector3f(BoundsExtent)});
+	PendingCandidateIndices.Add(ActorId, Index);
+	return Index;
+}
+
+
+void FPeripheryRecorder::FlushFrame()
+{
+	if (!Writer || PendingOwners.IsEmpty()) return;
+
+	uint32 RecordType = static_cast<uint32>(PeripheryRecording::ERecordType::Frame);
+	FPeripheryRecordedFrame Frame;
+	Frame.FrameNumber = static_cast<uint32>(PendingFrameNumber);
+	Frame.Time = PendingTime;
+	Frame.NumCandidates = PendingCandidates.Num();
+	Frame.NumOwners = PendingOwners.Num();
+
+	Writer->Serialize(&RecordType, sizeof(RecordType));
+	Writer->Serialize(&Frame, sizeof(Frame));
+	Writer->Serialize(PendingCandidates.GetData(), PendingCandidates.Num() * sizeof(FPeripheryRecordedCandidate));
+
+	int32 EntryIndex = 0;
+	for (FPeripheryRecordedOwner& Owner : PendingOwners)
+	{
+		Writer->Serialize(&Owner, sizeof(Owner));
+		Writer->Serialize(PendingEntries.GetData() + EntryIndex, Owner.NumEntries * sizeof(FPeripheryRecordedEntry));
+		EntryIndex += Owner.NumEntries;
+	}
+
+	PendingCandidates.Reset();
+	PendingCandidateIndices.Reset();
+	PendingOwners.Reset();
+	PendingEntries.Reset();
+}
+#pragma endregion
+
+
+
+#pragma region Reader
+FPeripheryRecordingReader::~FPeripheryRecordingReader()
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+}
+
+
+bool FPeripheryRecordingReader::Open(const FString& Filename)
+{
+	MappedRegion.Reset();
+	MappedFile.Reset();
+	LoadedFile.Reset();
+	Names.Reset();
+	Data = nullptr;
+	Size = 0;
+	Offset = 0;
+
+	// Map the recording, and fall back to reading the file if the platform doesn't support it
+	MappedFile = TUniquePtr<IMappedFileHandle>(FPlatformFileManager::Get().GetPlatformFile().OpenMapped(*Filename));
+	if (MappedFile && MappedFile->GetFileSize() > 0)
+	{
+		MappedRegion = TUniquePtr<IMappedFileRegion>(MappedFile->MapRegion(0, MappedFile->GetFileSize(), true));
+	}
+
+	if (MappedRegion)
+	{
+		Data = MappedRegion->GetMappedPtr();
+		Size = MappedRegion->GetMappedSize();
+	}
+	else if (FFileHelper::LoadFileToArray(LoadedFile, *Filename))
+	{
+		Data = LoadedFile.GetData();
+		Size = LoadedFile.Num();
+	}
+	else
+	{
+		UE_LOGFMT(PeripheryLog, Error, "{0}() -> Unable to read the periphery recording {1}", *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	FPeripheryRecordingHeader Header;
+	if (!Read(Header) || Header.Magic != PeripheryRecording::Magic || Header.Version != PeripheryRecording::Version)
+	{
+		UE_LOGFMT(PeripheryLog, Error, "{0}() -> {1} isn't a periphery recording, or was recorded with a different version", *FString(__FUNCTION__), *Filename);
+		return false;
+	}
+
+	return true;
+}
+
+
+bool FPeripheryRecordingReader::ReadFrame(FPeripheryRecordedFrame& OutFrame, TArray<FPeripheryRecordedCandidate>& OutCandidates, TArray<FPeripheryRecordedOwner>& OutOwners, TArray<FPeripheryRecordedEntry>& OutEntries)
+{
+	uint32 RecordType = 0;
+	while (Read(RecordType))
+	{
+		if (RecordType == static_cast<uint32>(PeripheryRecording::ERecordType::Name))
+		{
+			uint32 ActorId = 0;
+			uint32 NameLength = 0;
+			if (!Read(ActorId) || !Read(NameLength) || Offset + Align(static_cast<int64>(NameLength), 4) > Size) return false;
+
+			const FUTF8ToTCHAR Name(reinterpret_cast<const ANSICHAR*>(Data + Offset), NameLength);
+			Names.Add(ActorId, FString(Name.Length(), Name.Get()));
+			Offset += Align(NameLength, 4);
+		}
+		else if (RecordType == static_cast<uint32>(PeripheryRecording::ERecordType::Frame))
+		{
+			if (!Read(OutFrame) || !ReadArray(OutCandidates, OutFrame.NumCandidates)) return false;
+
+			OutOwners.Reset();
+			OutEntries.Reset();
+			for (uint32 OwnerIndex = 0; OwnerIndex < OutFrame.NumOwners; OwnerIndex++)
+			{
+				FPeripheryRecordedOwner& Owner = OutOwners.AddDefaulted_GetRef();
+				if (!Read(Owner)) return false;
+
+				// The entry count is checked before allocating anything, a corrupt count would otherwise allocate a huge array
+				if (Offset + static_cast<int64>(Owner.NumEntries * sizeof(FPeripheryRecordedEntry)) > Size) return false;
+				const int32 FirstEntry = OutEntries.Num();
+				OutEntries.AddUninitialized(Owner.NumEntries);
+				FMemory::Memcpy(OutEntries.GetData() + FirstEntry, Data + Offset, Owner.NumEntries * sizeof(FPeripheryRecordedEntry));
+				Offset += Owner.NumEntries * sizeof(FPeripheryRecordedEntry);
+			}
+
+			return true;
+		}
+		else
+		{
+			UE_LOGFMT(PeripheryLog, Error, "{0}() -> Unknown record type {1} at offset {2}", *FString(__FUNCTION__), RecordType, Offset);
+			return false;
+		}
+	}
+
+	return false;
+}
+
+
+FString FPeripheryRecordingReader::GetName(const uint32 ActorId) const
+{
+	const FString* Name = Names.Find(ActorId);
+	return Name ? *Name : FString::Printf(TEXT("Actor_%u"), ActorId);
+}
+
+
+template <typename T>
+bool FPeripheryRecordingReader::Read(T& Value)
+{
+	if (Offset + static_cast<int64>(sizeof(T)) > Size) return false;
+	FMemory::Memcpy(&Value, Data + Offset, sizeof(T));
+	Offset += sizeof(T);
+	return true;
+}
+
+
+template <typename T>
+bool FPeripheryRecordingReader::ReadArray(TArray<T>& Values, const uint32 Num)
+{
+	Values.Reset();
+	if (Offset + static_cast<int64>(Num * sizeof(T)) > Size) return false;
+	Values.AddUninitialized(Num);
+	FMemory::Memcpy(Values.GetData(), Data + Offset, Num * sizeof(T));
+	Offset += Num * sizeof(T);
+	return true;
+}
+#pragma endregion
+
+
+
+#pragma region Replay
+bool FPeripheryReplay::Run(FPeripheryRecordingReader& Reader, TArray<FPeripheryReplayEvent>& OutEvents, FPeripheryReplayStats& OutStats)
+{
+	FPeripheryRecordedFrame Frame;
+	TArray<FPeripheryRecordedCandidate> Candidates;
+	TArray<FPeripheryRecordedOwner> Owners;
+	TArray<FPeripheryRecordedEntry> Entries;
+
+	OwnerStates.Reset();
+	while (Reader.ReadFrame(Frame, Candidates, Owners, Entries))
+	{
+		const double StartTime = FPlatformTime::Seconds();
+
+		int32 EntryIndex = 0;
+		for (const FPeripheryRecordedOwner& Owner : Owners)
+		{
+			UpdateOwner(Frame, Owner, TConstArrayView<FPeripheryRecordedEntry>(Entries.GetData() + EntryIndex, Owner.NumEntries), Candidates, OutEvents, OutStats);
+			EntryIndex += Owner.NumEntries;
+		}
+
+		OutStats.DetectionSeconds += FPlatformTime::Seconds() - StartTime;
+		OutStats.NumFrames++;
+	}
+
+	return OutStats.NumFrames > 0;
+}
+
+
+void FPeripheryReplay::UpdateOwner(const FPeripheryRecordedFrame& Frame, const FPeripheryRecordedOwner& Owner, TConstArrayView<FPeripheryRecordedEntry> Entries,
+	const TArray<FPeripheryRecordedCandidate>& Candidates, TArray<FPeripheryReplayEvent>& OutEvents, FPeripheryReplayStats& OutStats)
+{
+	FOwnerState& State = OwnerStates.FindOrAdd(Owner.OwnerId);
+	OutStats.NumOwnerUpdates++;
+
+	auto AddEvent = [&](const uint32 ActorId, const EPeripheryKind Kind, const bool bEnter)
+	{
+		OutEvents.Add({Frame.FrameNumber, Frame.Time, Owner.OwnerId, ActorId, Kind, bEnter});
+	};
+
+	// Radius and cone membership
+	TSet<uint32> InRadius;
+	TSet<uint32> InCone;
+	const FVector Location(Owner.Location);
+	const FVector ConeOrigin(Owner.ConeOrigin);
+	const FVector ConeDirection(Owner.ConeDirection);
+	const float ConeSinHalfAngle = FMath::Sqrt(FMath::Max(1.0f - FMath::Square(Owner.ConeCosHalfAngle), 0.0f));
+	for (const FPeripheryRecordedEntry& Entry : Entries)
+	{
+		if (!Candidates.IsValidIndex(Entry.CandidateIndex)) continue;
+		const FPeripheryRecordedCandidate& Candidate = Candidates[Entry.CandidateIndex];
+		const FVector BoundsOrigin(Candidate.BoundsOrigin);
+		const FVector BoundsExtent(Candidate.BoundsExtent);
+		OutStats.NumCandidateTests++;
+
+		// The peripheries overlap the candidate's collision, so the candidates are tested with their bounds instead of their location
+		if ((Owner.Flags & PeripheryRecording::OF_Radius) && (Entry.Flags & PeripheryRecording::CF_ValidRadiusObject)
+			&& PeripheryDetection::IsBoxWithinRadius(Location, BoundsOrigin, BoundsExtent, Owner.Radius))
+		{
+			InRadius.Add(Candidate.ActorId);
+		}
+
+		if ((Owner.Flags & PeripheryRecording::OF_Cone) && (Entry.Flags & PeripheryRecording::CF_ValidConeObject)
+			&& PeripheryDetection::IsSphereWithinCone(ConeOrigin, ConeDirection, BoundsOrigin, BoundsExtent.Size(), Owner.ConeLength, Owner.ConeCosHalfAngle, ConeSinHalfAngle))
+		{
+			InCone.Add(Candidate.ActorId);
+		}
+	}
+
+	auto UpdateMembership = [&](TSet<uint32>& Previous, const TSet<uint32>& Current, const EPeripheryKind Kind)
+	{
+		for (const uint32 ActorId : Previous) if (!Current.Contains(ActorId)) AddEvent(ActorId, Kind, false);
+		for (const uint32 ActorId : Current) if (!Previous.Contains(ActorId)) AddEvent(ActorId, Kind, true);
+		Previous = Current;
+	};
+	UpdateMembership(State.InRadius, InRadius, EPeripheryKind::EPK_Radius);
+	UpdateMembership(State.InCone, InCone, EPeripheryKind::EPK_Cone);
+
+	// Trace transitions
+	if (Owner.Flags & PeripheryRecording::OF_Trace)
+	{
+		// Like the component, the same actor is still a transition when it's validity changes (for example while aiming at one of it's item instances)
+		const bool bTracedValid = (Owner.Flags & PeripheryRecording::OF_TracedValid) != 0;
+		const PeripheryDetection::FTraceTransition Transition = PeripheryDetection::ResolveTraceTransition(
+			State.TracedActorId != 0, State.bTracedValid,
+			Owner.TracedActorId != 0, bTracedValid,
+			State.TracedActorId == Owner.TracedActorId && State.bTracedValid == bTracedValid
+		);
+
+		if (Transition.bExitPrevious) AddEvent(State.TracedActorId, EPeripheryKind::EPK_Trace, false);
+		if (Transition.bEnterCurrent) AddEvent(Owner.TracedActorId, EPeripheryKind::EPK_Trace, true);
+		State.TracedActorId = Owner.TracedActorId;
+		State.bTracedValid = bTracedValid;
+	}
+}
+#pragma endregion
@@ -0,0 +1,72 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryReplayCommandlet.h"
+
+#include "PeripheryRecording.h"
+#include "PlayerPeripheriesComponent.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/FileHelper.h"
+
+
+UPeripheryReplayCommandlet::UPeripheryReplayCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+}
+
+
+int32 UPeripheryReplayCommandlet::Main(const FString& Params)
+{
+	FString RecordingFilename;
+	FString OutputFilename;
+	if (!FParse::Value(*Params, TEXT("Recording="), RecordingFilename))
+	{
+		UE_LOGFMT(PeripheryLog, Error, "Usage: -run=PeripheryReplay -Recording=<File.prec> [-Output=<Events.csv>]");
+		return 1;
+	}
+	FParse::Value(*Params, TEXT("Output="), OutputFilename);
+
+	FPeripheryRecordingReader Reader;
+	if (!Reader.Open(RecordingFilename)) return 1;
+
+	FPeripheryReplay Replay;
+	FPeripheryReplayStats Stats;
+	TArray<FPeripheryReplayEvent> Events;
+	if (!Replay.Run(Reader, Events, Stats))
+	{
+		UE_LOGFMT(PeripheryLog, Error, "{0} doesn't have any recorded frames", *RecordingFilename);
+		return 1;
+	}
+
+	UE_LOGFMT(PeripheryLog, Display, "Replayed {0} frames, {1} owner updates and {2} candidate tests in {3} ms ({4} us per frame), {5} events",
+		Stats.NumFrames, Stats.NumOwnerUpdates, Stats.NumCandidateTests,
+		Stats.DetectionSeconds * 1000.0, Stats.DetectionSeconds * 1000000.0 / Stats.NumFrames,
+		Events.Num()
+	);
+
+	if (!OutputFilename.IsEmpty())
+	{
+		FString Output = TEXT("Frame,Time,Owner,Periphery,Event,Actor\n");
+		for (const FPeripheryReplayEvent& Event : Events)
+		{
+			Output += FString::Printf(TEXT("%u,%.4f,%s,%s,%s,%s\n"),
+				Event.FrameNumber, Event.Time,
+				*Reader.GetName(Event.OwnerId),
+				*UEnum::GetDisplayValueAsText(Event.Kind).ToString(),
+				Event.bEnter ? TEXT("Enter") : TEXT("Exit"),
+				*Reader.GetName(Event.ActorId)
+			);
+		}
+
+		if (!FFileHelper::SaveStringToFile(Output, *OutputFilename))
+		{
+			UE_LOGFMT(PeripheryLog, Error, "Unable to save the replay events to {0}", *OutputFilename);
+			return 1;
+		}
+	}
+
+	return 0;
+}
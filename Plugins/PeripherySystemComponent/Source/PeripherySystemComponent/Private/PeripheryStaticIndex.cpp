@@ -0,0 +1,117 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryStaticIndex.h"
+
+#include "PeripheryObjectInterface.h"
+#include "PeripheryObjectRegistry.h"
+#include "PlayerPeripheriesComponent.h"
+#include "Engine/Level.h"
+#include "Engine/World.h"
+#include "Logging/MessageLog.h"
+#include "Logging/StructuredLog.h"
+#include "Misc/UObjectToken.h"
+#include "UObject/ObjectSaveContext.h"
+
+
+APeripheryStaticIndex::APeripheryStaticIndex(const FObjectInitializer& ObjectInitializer) : Super(ObjectInitializer)
+{
+	PrimaryActorTick.bCanEverTick = false;
+}
+
+
+void APeripheryStaticIndex::PostRegisterAllComponents()
+{
+	Super::PostRegisterAllComponents();
+
+	UWorld* World = GetWorld();
+	UPeripheryObjectRegistry* Registry = World && World->IsGameWorld() ? World->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	if (Registry) Registry->AddStaticIndex(*this);
+}
+
+
+#if WITH_EDITOR
+void APeripheryStaticIndex::BuildIndex()
+{
+	Modify();
+	PopulateIndex();
+}
+
+
+void APeripheryStaticIndex::PopulateIndex()
+{
+	const ULevel* Level = GetLevel();
+	if (!Level) return;
+
+	Actors.Reset();
+	Positions.Reset();
+	BoundsMin.Reset();
+	BoundsMax.Reset();
+	Types.Reset();
+	Teams.Reset();
+	Flags.Reset();
+	LocalBoundsOffsets.Reset();
+	BoundsRadii.Reset();
+	DynamicActors.Reset();
+
+	for (AActor* Actor : Level->Actors)
+	{
+		if (!Actor || Actor == this) continue;
+		if (!Actor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass())) continue;
+		if (!Actor->IsRootComponentStatic())
+		{
+			DynamicActors.Add(Actor);
+			continue;
+		}
+
+		const FPeripheryObjectInfo Info = UPeripheryObjectRegistry::CalculateObjectInfo(Actor);
+		FVector3f Min, Max;
+		UPeripheryObjectRegistry::CalculateBounds(Actor, Info.LocalBoundsOffset, Info.BoundsRadius, Min, Max);
+
+		Actors.Add(Actor);
+		Positions.Add(Actor->GetActorLocation());
+		BoundsMin.Add(Min);
+		BoundsMax.Add(Max);
+		Types.Add(Info.Type);
+		Teams.Add(Info.Team);
+		Flags.Add(Info.Flags);
+		LocalBoundsOffsets.Add(Info.LocalBoundsOffset);
+		BoundsRadii.Add(Info.BoundsRadius);
+	}
+
+	UE_LOGFMT(PeripheryLog, Log, "{0}: Built the periphery static index with {1} objects ({2} dynamic objects)", *GetNameSafe(this), Actors.Num(), DynamicActors.Num());
+}
+
+
+void APeripheryStaticIndex::CheckForErrors()
+{
+	Super::CheckForErrors();
+
+	int32 NumMoved = 0;
+	for (int32 IndexedObject = 0; IndexedObject < Actors.Num(); IndexedObject++)
+	{
+		if (HasMoved(IndexedObject)) NumMoved++;
+	}
+
+	if (NumMoved > 0)
+	{
+		FMessageLog("MapCheck").Warning()
+			->AddToken(FUObjectToken::Create(this))
+			->AddToken(FTextToken::Create(FText::FromString(FString::Printf(TEXT("%d of the indexed periphery objects have moved since the index was built, rebuild the index"), NumMoved))));
+	}
+}
+
+
+bool APeripheryStaticIndex::HasMoved(const int32 IndexedObject) const
+{
+	const AActor* Actor = Actors.IsValidIndex(IndexedObject) ? Actors[IndexedObject].Get() : nullptr;
+	return Actor && !Actor->GetActorLocation().Equals(Positions[IndexedObject], 1.0);
+}
+
+
+void APeripheryStaticIndex::PreSave(FObjectPreSaveContext ObjectSaveContext)
+{
+	if (bBuildOnSave && !ObjectSaveContext.IsProceduralSave()) PopulateIndex();
+	Super::PreSave(ObjectSaveContext);
+}
+#endif
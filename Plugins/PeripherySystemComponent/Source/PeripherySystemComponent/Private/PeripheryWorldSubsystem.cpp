@@ -0,0 +1,180 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryWorldSubsystem.h"
+
+#include "Camera/PlayerCameraManager.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/World.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/DateTime.h"
+#include "Misc/Paths.h"
+
+
+static FAutoConsoleCommandWithWorldAndArgs PeripheryRecordStartCommand(
+	TEXT("Periphery.Record.Start"),
+	TEXT("Records every periphery component in the world for the offline replay. Periphery.Record.Start [Filename]"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UPeripheryWorldSubsystem* PeripherySubsystem = World ? World->GetSubsystem<UPeripheryWorldSubsystem>() : nullptr;
+		if (PeripherySubsystem) PeripherySubsystem->StartRecording(Args.Num() ? Args[0] : FString());
+	})
+);
+
+static FAutoConsoleCommandWithWorldAndArgs PeripheryRecordStopCommand(
+	TEXT("Periphery.Record.Stop"),
+	TEXT("Stops recording the periphery components"),
+	FConsoleCommandWithWorldAndArgsDelegate::CreateLambda([](const TArray<FString>& Args, UWorld* World)
+	{
+		UPeripheryWorldSubsystem* PeripherySubsystem = World ? World->GetSubsystem<UPeripheryWorldSubsystem>() : nullptr;
+		if (PeripherySubsystem) PeripherySubsystem->StopRecording();
+	})
+);
+
+
+void UPeripheryWorldSubsystem::Deinitialize()
+{
+	StopRecording();
+	Super::Deinitialize();
+}
+
+
+FPeripheryAimRay UPeripheryWorldSubsystem::GetAimRay(const AActor* Owner)
+{
+	if (!Owner) return FPeripheryAimRay();
+
+	// Clear out the previous frame's aim rays
+	if (AimRaysFrame != GFrameCounter)
+	{
+		AimRays.Reset();
+		AimRaysFrame = GFrameCounter;
+	}
+
+	const AController* Controller = FindViewController(Owner);
+	const FObjectKey Key = Controller ? FObjectKey(Controller) : FObjectKey(Owner);
+	if (const FPeripheryAimRay* AimRay = AimRays.Find(Key))
+	{
+		return *AimRay;
+	}
+
+	return AimRays.Add(Key, CalculateAimRay(Owner, Controller));
+}
+
+
+AController* UPeripheryWorldSubsystem::FindViewController(const AActor* Owner)
+{
+	if (!Owner) return nullptr;
+	if (const APawn* Pawn = Cast<APawn>(Owner)) return Pawn->GetController();
+	if (const AController* Controller = Cast<AController>(Owner)) return const_cast<AController*>(Controller);
+	return Owner->GetInstigatorController();
+}
+
+
+FPeripheryAimRay UPeripheryWorldSubsystem::CalculateAimRay(const AActor* Owner, const AController* Controller)
+{
+	FPeripheryAimRay AimRay;
+	FRotator ViewRotation;
+
+	// Player controllers use the camera manager's view point (this is the center of the screen, and is also updated on the server for remote players)
+	const APlayerController* PlayerController = Cast<APlayerController>(Controller);
+	if (PlayerController && PlayerController->PlayerCameraManager)
+	{
+		PlayerController->PlayerCameraManager->GetCameraViewPoint(AimRay.Origin, ViewRotation);
+	}
+	else if (Controller)
+	{
+		Controller->GetPlayerViewPoint(AimRay.Origin, ViewRotation);
+	}
+	else if (Owner)
+	{
+		Owner->GetActorEyesViewPoint(AimRay.Origin, ViewRotation);
+	}
+
+	AimRay.Direction = ViewRotation.Vector();
+	return AimRay;
+}
+
+
+bool UPeripheryWorldSubsystem::StartRecording(const FString& Filename)
+{
+	const FString RecordingFilename = !Filename.IsEmpty()
+		? Filename
+		: FPaths::ProjectSavedDir() / TEXT("Periphery") / FString::Printf(TEXT("Periphery-%s.prec"), *FDateTime::Now().ToString());
+	return Recorder.Start(RecordingFilename);
+}
+
+
+void UPeripheryWorldSubsystem::StopRecording()
+{
+	Recorder.Stop();
+}
+
+
+bool UPeripheryWorldSubsystem::IsRecording() const
+{
+	return Recorder.IsRecording();
+}
+
+
+TSharedPtr<const TArray<FOverlapResult>> UPeripheryWorldSubsystem::GetSharedOverlaps(const FVector& Location, const float Radius, const FCollisionObjectQueryParams& ObjectQueryParams, const float CellSize)
+{
+	if (SharedQueriesFrame != GFrameCounter)
+	{
+		SharedQueries.Reset();
+		SharedQueriesFrame = GFrameCounter;
+		NumSharedQueries = 0;
+		NumSharedQueryRequests = 0;
+	}
+
+	const float SafeCellSize = FMath::Max(CellSize, 1.0f);
+	const FIntVector Cell(
+		FMath::FloorToInt(Location.X / SafeCellSize),
+		FMath::FloorToInt(Location.Y / SafeCellSize),
+		FMath::FloorToInt(Location.Z / SafeCellSize)
+	);
+
+	NumSharedQueryRequests++;
+	const FSharedQueryKey Key{Cell, SafeCellSize, ObjectQueryParams.GetQueryBitfield(), Radius};
+	if (const TSharedPtr<const TArray<FOverlapResult>>* SharedQuery = SharedQueries.Find(Key))
+	{
+		return *SharedQuery;
+	}
+
+	// Query from the center of the cell, with enough padding to reach the radius from any of it's corners
+	const FVector CellCenter = (FVector(Cell) + FVector(0.5)) * SafeCellSize;
+	const float Padding = SafeCellSize * UE_HALF_SQRT_3;
+	TSharedPtr<TArray<FOverlapResult>> Overlaps = MakeShared<TArray<FOverlapResult>>();
+	GetWorld()->OverlapMultiByObjectType(*Overlaps, CellCenter, FQuat::Identity, ObjectQueryParams, FCollisionShape::MakeSphere(Radius + Padding),
+		FCollisionQueryParams(SCENE_QUERY_STAT(PeripherySharedQuery), false)
+	);
+
+	NumSharedQueries++;
+	SharedQueries.Add(Key, Overlaps);
+	return Overlaps;
+}
+
+
+TSharedRef<FPeripheryEventChannel> UPeripheryWorldSubsystem::CreateEventChannel(const uint32 Capacity)
+{
+	check(IsInGameThread());
+	return EventChannels.Add_GetRef(MakeShared<FPeripheryEventChannel>(Capacity));
+}
+
+
+void UPeripheryWorldSubsystem::RemoveEventChannel(const TSharedRef<FPeripheryEventChannel>& EventChannel)
+{
+	check(IsInGameThread());
+	EventChannels.Remove(EventChannel);
+}
+
+
+void UPeripheryWorldSubsystem::PublishEvent(const FPeripheryEventRecord& Record) const
+{
+	check(IsInGameThread());
+	for (const TSharedRef<FPeripheryEventChannel>& EventChannel : EventChannels)
+	{
+		EventChannel->Publish(Record);
+	}
+}
@@ -3,10 +3,21 @@
 
 #include "PlayerPeripheriesComponent.h"
 
+#include "PeripheryConfig.h"
+#include "PeripheryDetection.h"
+#include "PeripheryHighlightSubsystem.h"
+#include "PeripheryItemInstancesComponent.h"
 #include "PeripheryObjectInterface.h"
+#include "PeripheryObjectRegistry.h"
+#include "PeripheryRecording.h"
+#include "PeripheryWorldSubsystem.h"
 #include "Components/SphereComponent.h"
+#include "Engine/OverlapResult.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/World.h"
 #include "GameFramework/Character.h"
-#include "Kismet/GameplayStatics.h"
+#include "GameFramework/GameStateBase.h"
+#include "Kismet/KismetSystemLibrary.h"
 #include "Logging/StructuredLog.h"
 
 DEFINE_LOG_CATEGORY(PeripheryLog)
@@ -29,12 +40,10 @@ UPlayerPeripheriesComponent::UPlayerPeripheriesComponent(const FObjectInitialize
 	PeripheryRadius->SetCastHiddenShadow(false);
 
 	PeripheryRadius->SetGenerateOverlapEvents(true);
-	PeripheryRadius->SetCollisionObjectType(PeripheryRadiusChannel);
 	PeripheryRadius->SetCollisionResponseToAllChannels(ECR_Ignore);
 	PeripheryRadius->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	PeripheryRadius->SetCollisionResponseToChannel(ECC_WorldDynamic, ECollisionResponse::ECR_Overlap);
 	PeripheryRadius->SetCollisionResponseToChannel(ECC_Pawn, ECollisionResponse::ECR_Overlap);
-	PeripheryRadius->SetCollisionResponseToChannel(PeripheryRadiusChannel, ECollisionResponse::ECR_Overlap);
 
 	PeripheryCone = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("Periphery Cone"));
 	// PeripheryCone->SetupAttachment(GetOwner()->GetRootComponent());
@@ -43,12 +52,10 @@ UPlayerPeripheriesComponent::UPlayerPeripheriesComponent(const FObjectInitialize
 	PeripheryCone->SetCastHiddenShadow(false);
 	
 	PeripheryCone->SetGenerateOverlapEvents(true);
-	PeripheryCone->SetCollisionObjectType(PeripheryConeChannel);
 	PeripheryCone->SetCollisionResponseToAllChannels(ECR_Ignore);
 	PeripheryCone->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	PeripheryCone->SetCollisionResponseToChannel(ECC_WorldDynamic, ECollisionResponse::ECR_Overlap);
 	PeripheryCone->SetCollisionResponseToChannel(ECC_Pawn, ECollisionResponse::ECR_Overlap);
-	PeripheryCone->SetCollisionResponseToChannel(PeripheryConeChannel, ECollisionResponse::ECR_Overlap);
 
 	ItemDetection = CreateDefaultSubobject<USphereComponent>(TEXT("Item Detection"));
 	// ItemDetection->SetupAttachment(GetOwner()->GetRootComponent());
@@ -57,51 +64,148 @@ UPlayerPeripheriesComponent::UPlayerPeripheriesComponent(const FObjectInitialize
 	ItemDetection->SetCastHiddenShadow(false);
 
 	ItemDetection->SetGenerateOverlapEvents(true);
-	ItemDetection->SetCollisionObjectType(ItemDetectionChannel);
 	ItemDetection->SetCollisionResponseToChannels(ECR_Ignore);
 	ItemDetection->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
 	ItemDetection->SetCollisionResponseToChannel(ECC_WorldDynamic, ECollisionResponse::ECR_Overlap);
-	ItemDetection->SetCollisionResponseToChannel(ItemDetectionChannel, ECollisionResponse::ECR_Overlap);
 
 	/** Periphery Values */
 	bCone = false;
 	bTrace = false;
 	bRadius = true;
 	bItemDetection = false;
+	bRadiusRings = false;
 	bInitPeripheryDuringBeginPlay = true;
 	ActivationPhase = EHandlePeripheryLogic::EP_Server;
+	ScriptValidators = 0;
 	
 	/** Periphery Radius */
-	PeripheryRadiusChannel = ECC_Pawn;
-	ValidPeripheryRadiusObjects = APawn::StaticClass();
 	PeripheryRadius->ShapeColor = FColor(116, 134, 29, 255);
 	PeripheryRadius->SetSphereRadius(1340);
 	
+	/** Radius Rings */
+	RadiusRingsTimeSinceUpdate = 0;
+	RadiusRingsUpdateStep = INDEX_NONE;
+	
 	/** Item Detection */
-	ItemDetectionChannel = ECC_GameTraceChannel1;
-	ValidItemDetectionObjects = AActor::StaticClass();
 	ItemDetection->ShapeColor = FColor(150,255,108,255);
 	ItemDetection->SetSphereRadius(100);
 	ItemDetection->SetRelativeLocation(FVector(0, 0, -79));
 
-	/** Periphery Cone */
-	PeripheryConeChannel = ECC_Pawn;
-	ValidPeripheryConeObjects = APawn::StaticClass();
+#if WITH_EDITORONLY_DATA
+	/** Deprecated, these are the defaults the settings had on the component so only the values that were changed are migrated */
+	PeripheryRadiusChannel_DEPRECATED = ECC_Pawn;
+	ValidPeripheryRadiusObjects_DEPRECATED = APawn::StaticClass();
+	bDebugPeripheryRadius_DEPRECATED = false;
+	ItemDetectionChannel_DEPRECATED = ECC_GameTraceChannel1;
+	ValidItemDetectionObjects_DEPRECATED = AActor::StaticClass();
+	bDebugItemDetection_DEPRECATED = false;
+	PeripheryConeChannel_DEPRECATED = ECC_Pawn;
+	ValidPeripheryConeObjects_DEPRECATED = APawn::StaticClass();
+	bDebugPeripheryCone_DEPRECATED = false;
+	PeripheryLineTraceObjectTypes_DEPRECATED.Add(EObjectTypeQuery::ObjectTypeQuery2);
+	PeripheryLineTraceObjectTypes_DEPRECATED.Add(EObjectTypeQuery::ObjectTypeQuery3);
+	PeripheryLineTraceObjectTypes_DEPRECATED.Add(EObjectTypeQuery::ObjectTypeQuery1);
+	PeripheryLineTraceObjectTypes_DEPRECATED.Add(EObjectTypeQuery::ObjectTypeQuery4);
+	ValidPeripheryTraceObjects_DEPRECATED = AActor::StaticClass();
+	PeripheryTraceDistance_DEPRECATED = 6400;
+	PeripheryTraceForwardOffset_DEPRECATED = 34.0;
+	TraceShouldIgnoreOwnerActors_DEPRECATED = true;
+	bDebugPeripheryTrace_DEPRECATED = false;
+	bDrawTraceDebug_DEPRECATED = false;
+#endif
+}
+
+
+void UPlayerPeripheriesComponent::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+	MigrateDeprecatedConfig();
+#endif
+}
+
+
+#if WITH_EDITORONLY_DATA
+void UPlayerPeripheriesComponent::MigrateDeprecatedConfig()
+{
+	// The deprecated settings aren't saved, so once the component is saved again they're back to their defaults and nothing is migrated
+	const UPlayerPeripheriesComponent* Defaults = GetDefault<UPlayerPeripheriesComponent>();
+	UPeripheryConfig* Config = PeripheryConfigOverride;
+	bool bMigrated = false;
+	auto Migrate = [this, &Config, &bMigrated](auto& Deprecated, const auto& Default, auto&& SetConfigValue)
+	{
+		if (Deprecated == Default) return;
+		bMigrated = true;
+
+		// The override starts from the shared config (or the default config), and only the changed settings are replaced
+		if (!Config)
+		{
+			Config = NewObject<UPeripheryConfig>(this, UPeripheryConfig::StaticClass(), NAME_None, GetMaskedFlags(RF_PropagateToSubObjects), PeripheryConfig);
+			PeripheryConfigOverride = Config;
+		}
+
+		SetConfigValue(*Config, Deprecated);
+		Deprecated = Default;
+	};
 
-	/** Periphery Trace */
-	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery2);
-	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery3);
-	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery1);
-	PeripheryLineTraceObjectTypes.Add(EObjectTypeQuery::ObjectTypeQuery4);
-	ValidPeripheryTraceObjects = AActor::StaticClass();
-	PeripheryTraceDistance = 6400;
-	PeripheryTraceForwardOffset = 34.0;
-	TraceShouldIgnoreOwnerActors = true;
+	auto SetFilterClass = [](FPeripheryFilter& Filter, const TSubclassOf<AActor>& ValidClass)
+	{
+		Filter.ValidClasses.Reset();
+		if (ValidClass) Filter.ValidClasses.Add(ValidClass);
+	};
+
+	Migrate(PeripheryRadiusChannel_DEPRECATED, Defaults->PeripheryRadiusChannel_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.PeripheryRadiusChannel = Value; });
+	Migrate(ValidPeripheryRadiusObjects_DEPRECATED, Defaults->ValidPeripheryRadiusObjects_DEPRECATED, [&](UPeripheryConfig& Target, const auto& Value) { SetFilterClass(Target.RadiusFilter, Value); });
+	Migrate(bDebugPeripheryRadius_DEPRECATED, Defaults->bDebugPeripheryRadius_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.bDebugPeripheryRadius = Value; });
+	Migrate(ItemDetectionChannel_DEPRECATED, Defaults->ItemDetectionChannel_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.ItemDetectionChannel = Value; });
+	Migrate(ValidItemDetectionObjects_DEPRECATED, Defaults->ValidItemDetectionObjects_DEPRECATED, [&](UPeripheryConfig& Target, const auto& Value) { SetFilterClass(Target.ItemDetectionFilter, Value); });
+	Migrate(bDebugItemDetection_DEPRECATED, Defaults->bDebugItemDetection_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.bDebugItemDetection = Value; });
+	Migrate(PeripheryConeChannel_DEPRECATED, Defaults->PeripheryConeChannel_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.PeripheryConeChannel = Value; });
+	Migrate(ValidPeripheryConeObjects_DEPRECATED, Defaults->ValidPeripheryConeObjects_DEPRECATED, [&](UPeripheryConfig& Target, const auto& Value) { SetFilterClass(Target.ConeFilter, Value); });
+	Migrate(bDebugPeripheryCone_DEPRECATED, Defaults->bDebugPeripheryCone_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.bDebugPeripheryCone = Value; });
+	Migrate(PeripheryLineTraceObjectTypes_DEPRECATED, Defaults->PeripheryLineTraceObjectTypes_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.PeripheryLineTraceObjectTypes = Value; });
+	Migrate(ValidPeripheryTraceObjects_DEPRECATED, Defaults->ValidPeripheryTraceObjects_DEPRECATED, [&](UPeripheryConfig& Target, const auto& Value) { SetFilterClass(Target.TraceFilter, Value); });
+	Migrate(PeripheryTraceDistance_DEPRECATED, Defaults->PeripheryTraceDistance_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.PeripheryTraceDistance = Value; });
+	Migrate(PeripheryTraceForwardOffset_DEPRECATED, Defaults->PeripheryTraceForwardOffset_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.PeripheryTraceForwardOffset = Value; });
+	Migrate(TraceShouldIgnoreOwnerActors_DEPRECATED, Defaults->TraceShouldIgnoreOwnerActors_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.TraceShouldIgnoreOwnerActors = Value; });
+	Migrate(bDebugPeripheryTrace_DEPRECATED, Defaults->bDebugPeripheryTrace_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.bDebugPeripheryTrace = Value; });
+	Migrate(bDrawTraceDebug_DEPRECATED, Defaults->bDrawTraceDebug_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.bDrawTraceDebug = Value; });
+	Migrate(TraceColor_DEPRECATED, Defaults->TraceColor_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.TraceColor = Value; });
+	Migrate(TraceHitColor_DEPRECATED, Defaults->TraceHitColor_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.TraceHitColor = Value; });
+	Migrate(TraceDuration_DEPRECATED, Defaults->TraceDuration_DEPRECATED, [](UPeripheryConfig& Target, const auto& Value) { Target.TraceDuration = Value; });
+
+	if (bMigrated)
+	{
+		Config->CompileFilters();
+		UE_LOGFMT(PeripheryLog, Log, "{0}: Moved the periphery settings that were set on the component into it's config override, resave it to keep them", *GetPathNameSafe(this));
+	}
 }
+#endif
 
 
 void UPlayerPeripheriesComponent::InitPeripheryInformation()
 {
+	// The collision channels are part of the config, so they're applied once the config has been assigned
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	if (PeripheryRadius)
+	{
+		PeripheryRadius->SetCollisionObjectType(Config->PeripheryRadiusChannel);
+		PeripheryRadius->SetCollisionResponseToChannel(Config->PeripheryRadiusChannel, ECollisionResponse::ECR_Overlap);
+	}
+
+	if (PeripheryCone)
+	{
+		PeripheryCone->SetCollisionObjectType(Config->PeripheryConeChannel);
+		PeripheryCone->SetCollisionResponseToChannel(Config->PeripheryConeChannel, ECollisionResponse::ECR_Overlap);
+	}
+
+	if (ItemDetection)
+	{
+		ItemDetection->SetCollisionObjectType(Config->ItemDetectionChannel);
+		ItemDetection->SetCollisionResponseToChannel(Config->ItemDetectionChannel, ECollisionResponse::ECR_Overlap);
+	}
+
 	// Initialize the periphery
 	if (PeripheryRadius && ActivatePeripheryLogic(ActivationPhase))
 	{
@@ -131,19 +235,35 @@ void UPlayerPeripheriesComponent::BeginPlay()
 {
 	Super::BeginPlay();
 	GetCharacter();
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (GetOwner() && TraceShouldIgnoreOwnerActors)
+	if (GetOwner() && Config->TraceShouldIgnoreOwnerActors)
 	{
 		IgnoredActors.AddUnique(GetOwner());
 		GetOwner()->GetAllChildActors(IgnoredActors);
 	}
 
+	FindScriptValidators();
 	if (bInitPeripheryDuringBeginPlay) InitPeripheryInformation();
 }
 
 
 void UPlayerPeripheriesComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
 {
+	ActorsInRadiusRings.Empty();
+	for (const FPeripheryItemInstance& Instance : DetectedItemInstances)
+	{
+		if (Instance.Component) Instance.Component->OnItemInstanceRemoved.RemoveAll(this);
+	}
+	if (TracedItemInstance.Component) TracedItemInstance.Component->OnItemInstanceRemoved.RemoveAll(this);
+	DetectedItemInstances.Empty();
+	TracedItemInstance = FPeripheryItemInstance();
+	RadiusRingCandidates.Empty();
+	RadiusRingSchedule.Empty();
+	if (UPeripheryHighlightSubsystem* HighlightSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryHighlightSubsystem>() : nullptr)
+	{
+		HighlightSubsystem->ClearObserver(this);
+	}
 	Super::EndPlay(EndPlayReason);
 }
 
@@ -167,11 +287,43 @@ void UPlayerPeripheriesComponent::ConfigurePeripheryCollision(UPrimitiveComponen
 void UPlayerPeripheriesComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 	
 	if (bTrace && ActivatePeripheryLogic(ActivationPhase))
 	{
 		HandlePeripheryLineTrace();
 	}
+
+	if (bRadiusRings && ActivatePeripheryLogic(ActivationPhase))
+	{
+		// Shared queries are only shared within the same frame, so those owners update on the same intervals of the world's time
+		if (Config->bShareRadiusRingQueries && Config->RadiusRingsUpdateInterval > 0)
+		{
+			const int64 UpdateStep = FMath::FloorToInt64(GetWorld()->GetTimeSeconds() / Config->RadiusRingsUpdateInterval);
+			if (UpdateStep != RadiusRingsUpdateStep)
+			{
+				RadiusRingsUpdateStep = UpdateStep;
+				UpdateRadiusRings();
+			}
+		}
+		else
+		{
+			RadiusRingsTimeSinceUpdate += DeltaTime;
+			if (RadiusRingsTimeSinceUpdate >= Config->RadiusRingsUpdateInterval)
+			{
+				RadiusRingsTimeSinceUpdate = 0;
+				UpdateRadiusRings();
+			}
+		}
+
+		if (Config->bPredictRadiusRings) UpdateRadiusRingCandidates();
+	}
+
+	UPeripheryWorldSubsystem* PeripherySubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryWorldSubsystem>() : nullptr;
+	if (PeripherySubsystem && PeripherySubsystem->IsRecording() && ActivatePeripheryLogic(ActivationPhase))
+	{
+		RecordPeriphery(PeripherySubsystem->GetRecorder());
+	}
 }
 
 
@@ -180,29 +332,36 @@ void UPlayerPeripheriesComponent::TickComponent(float DeltaTime, ELevelTick Tick
 #pragma region Periphery functions
 void UPlayerPeripheriesComponent::PeripheryLineTrace_Implementation(FHitResult& Result)
 {
-	FVector_NetQuantize10 AimLocation = GetOwner()->GetActorLocation();
-	FVector_NetQuantize10 AimForwardVector = GetOwner()->GetActorForwardVector();
-	
-	FVector2D ViewportSize;
-	if (GEngine && GEngine->GameViewport) GEngine->GameViewport->GetViewportSize(ViewportSize);
-	const FVector2D CrosshairScreenLocation(ViewportSize.X / 2.f, ViewportSize.Y / 2.f);
-	if (APlayerController* PlayerController = UGameplayStatics::GetPlayerController(GetOwner(), 0))
-	{
-		UGameplayStatics::DeprojectScreenToWorld(
-			PlayerController,
-			CrosshairScreenLocation,
-			AimLocation, // Center of the screen deprojected to the world
-			AimForwardVector // The forward vector (where the vector is aiming)
-		);
-	}
-
-	AimLocation = AimLocation + (AimForwardVector * PeripheryTraceForwardOffset);
-	const FVector_NetQuantize AimDirection = AimLocation + (AimForwardVector * PeripheryTraceDistance); // This calculation is an fvector from our crosshair outwards
-	const FVector StartLocation = AimLocation;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	const FPeripheryAimRay AimRay = GetPeripheryAimRay();
+	const FVector StartLocation = AimRay.Origin + (AimRay.Direction * Config->PeripheryTraceForwardOffset);
+	FVector EndLocation = StartLocation + (AimRay.Direction * Config->PeripheryTraceDistance); // This calculation is an fvector from our crosshair outwards
+
+	// Only trace if the aim ray passes through one of the registered objects, and stop after the farthest one
+	const UPeripheryObjectRegistry* Registry = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	if (Config->bPrefilterTrace && Registry)
+	{
+		// The owner (and anything else the trace ignores) shouldn't keep the trace going
+		TArray<FPeripheryHandle, TInlineAllocator<8>> IgnoredHandles;
+		for (const AActor* IgnoredActor : IgnoredActors)
+		{
+			const FPeripheryHandle Handle = Registry->FindHandle(IgnoredActor);
+			if (Handle.IsSet()) IgnoredHandles.Add(Handle);
+		}
+
+		float NearDistance, FarDistance;
+		if (!Registry->RaycastBounds(StartLocation, AimRay.Direction, Config->PeripheryTraceDistance, IgnoredHandles, NearDistance, FarDistance))
+		{
+			Result = FHitResult(StartLocation, EndLocation);
+			return;
+		}
+
+		EndLocation = StartLocation + (AimRay.Direction * FarDistance);
+	}
 	
 	UKismetSystemLibrary::LineTraceSingleForObjects(
-		GetWorld(), StartLocation, AimDirection, PeripheryLineTraceObjectTypes, false, IgnoredActors,
-		bDrawTraceDebug ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None, Result, true, TraceColor, TraceHitColor, TraceDuration
+		GetWorld(), StartLocation, EndLocation, Config->PeripheryLineTraceObjectTypes, false, IgnoredActors,
+		Config->bDrawTraceDebug ? EDrawDebugTrace::ForDuration : EDrawDebugTrace::None, Result, true, Config->TraceColor, Config->TraceHitColor, Config->TraceDuration
 	);
 }
 
@@ -210,92 +369,343 @@ void UPlayerPeripheriesComponent::PeripheryLineTrace_Implementation(FHitResult&
 void UPlayerPeripheriesComponent::HandlePeripheryLineTrace_Implementation()
 {
 	GetCharacter();
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
 	FHitResult TraceResult;
 	PeripheryLineTrace(TraceResult);
 
 	// Periphery logic
 	TracedActor = TraceResult.GetActor();
-	const bool bIsTraceValidPeripheryObject = IsValidTracedObject(TracedActor, TraceResult);
+	const UPeripheryObjectRegistry* Registry = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	TracedHandle = Registry ? Registry->FindHandle(TracedActor) : FPeripheryHandle();
+	const bool bIsTraceValidPeripheryObject = IsValidPeripheryObject(EPeripheryKind::EPK_Trace, TracedActor, nullptr, nullptr, 0, false, TraceResult);
+
+	// Instanced items are traced individually, so aiming at another instance of the same component is still a transition
+	const FPeripheryItemInstance TraceInstance = bIsTraceValidPeripheryObject ? FPeripheryItemInstance::Find(TraceResult.GetComponent(), TraceResult.Item) : FPeripheryItemInstance();
+	if (TraceInstance != TracedItemInstance)
+	{
+		if (TracedItemInstance.IsSet()) HandleItemInstanceTransition(TracedItemInstance, EPeripheryKind::EPK_Trace, false);
+		if (TraceInstance.IsSet())
+		{
+			BindItemInstanceRemoved(TraceInstance.Component);
+			HandleItemInstanceTransition(TraceInstance, EPeripheryKind::EPK_Trace, true);
+		}
+	}
+	TracedItemInstance = TraceInstance;
+
+	// Item instances replace the actor's trace events, so the actor is only valid while the trace isn't aiming at one of it's instances
+	const bool bTracedActorEvents = bIsTraceValidPeripheryObject && !TraceInstance.IsSet();
 	
 	// Only activate the enter overlap logic once (this also handles if they aren't already aiming at something, and still aren't)
-	if (TracedActor == PreviousTracedActor) return;
+	if (TracedActor == PreviousTracedActor && bTracedActorEvents == bIsPreviousTraceValidPeripheryObject) return;
 	
-	// if the player isn't already aiming at anything
-	if (!PreviousTracedActor)
+	const PeripheryDetection::FTraceTransition Transition = PeripheryDetection::ResolveTraceTransition(
+		PreviousTracedActor != nullptr, bIsPreviousTraceValidPeripheryObject,
+		TracedActor != nullptr, bTracedActorEvents,
+		false
+	);
+	const bool bPeripheryInterface = TracedActor && TracedActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
+	const bool bPreviousActorPeripheryInterface = PreviousTracedActor && PreviousTracedActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
+
+	// Transition out of aiming at the previous object
+	if (Transition.bExitPrevious)
 	{
-		if (TracedActor && bIsTraceValidPeripheryObject)
-		{
-			// If this is a periphery object with custom logic, activate the functions
-			const bool bPeripheryInterface = TracedActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
-			if (bPeripheryInterface) IPeripheryObjectInterface::Execute_WithinPlayerTracePeriphery(TracedActor, Player, FindPeripheryType(TracedActor));
+		// If this is a periphery object with custom logic, activate the functions
+		if (bPreviousActorPeripheryInterface) IPeripheryObjectInterface::Execute_OutsideOfPlayerTracePeriphery(PreviousTracedActor, Player, FindPeripheryType(PreviousTracedActor));
 
-			// Periphery Trace delegates
-			ObjectInPeripheryTrace.Broadcast(TracedActor, Player, TraceResult);
+		// Periphery Trace delegates
+		ObjectOutsideOfPeripheryTrace.Broadcast(PreviousTracedActor, Player, TraceResult);
+		PublishPeripheryEvent(PreviousTracedActor, EPeripheryKind::EPK_Trace, false);
+		UpdatePeripheryHighlight(PreviousTracedActor, EPeripheryKind::EPK_Trace, false);
+	}
 
-			if (bDebugPeripheryTrace)
+	// Transition to aiming at the current object
+	if (Transition.bEnterCurrent)
+	{
+		// If this is a periphery object with custom logic, activate the functions
+		if (bPeripheryInterface) IPeripheryObjectInterface::Execute_WithinPlayerTracePeriphery(TracedActor, Player, FindPeripheryType(TracedActor));
+
+		// Periphery Trace delegates
+		ObjectInPeripheryTrace.Broadcast(TracedActor, Player, TraceResult);
+		PublishPeripheryEvent(TracedActor, EPeripheryKind::EPK_Trace, true);
+		UpdatePeripheryHighlight(TracedActor, EPeripheryKind::EPK_Trace, true);
+	}
+
+	if (Config->bDebugPeripheryTrace)
+	{
+		// if the player wasn't already aiming at anything
+		if (!PreviousTracedActor)
+		{
+			if (Transition.bEnterCurrent)
 			{
 				if (bPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Started looking at {2}(PeripheryInt)", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()), *GetNameSafe(TracedActor));
 				else UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Started looking at {2}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()), *GetNameSafe(TracedActor));
 			}
 		}
+		else if (TracedActor)
+		{
+			UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Transitioned looking at {2}{3} to {4}{5}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()),
+				*GetNameSafe(PreviousTracedActor),
+				bPreviousActorPeripheryInterface ? "(PeripheryInt)" : "",
+				*GetNameSafe(TracedActor),
+				bPeripheryInterface ? "(PeripheryInt)" : ""
+			);
+		}
+		else
+		{
+			if (bPreviousActorPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Stopped looking at {2}(PeripheryInt)", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()), *GetNameSafe(PreviousTracedActor));
+			else UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Stopped looking at {2}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()), *GetNameSafe(PreviousTracedActor));
+		}
 	}
 	
-	// Transition to aiming at another object, or transition out of aiming at an object
-	else if (TracedActor)
+	bIsPreviousTraceValidPeripheryObject = bTracedActorEvents;
+	PreviousTracedActor = TracedActor; // Cached for on exit traces
+}
+
+
+void UPlayerPeripheriesComponent::UpdateRadiusRings()
+{
+	if (!GetCharacter() || !GetWorld()) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	ActorsInRadiusRings.SetNum(Config->RadiusRings.Num());
+	if (Config->RadiusRings.IsEmpty()) return;
+
+	// A single proximity query for the largest ring, with every ring's channel
+	float MaxRadius = 0;
+	FCollisionObjectQueryParams ObjectQueryParams;
+	for (const FPeripheryRadiusRing& Ring : Config->RadiusRings)
 	{
-		const bool bPeripheryInterface = TracedActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
-		const bool bPreviousActorPeripheryInterface = PreviousTracedActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
-		
-		if (bIsPreviousTraceValidPeripheryObject)
+		MaxRadius = FMath::Max(MaxRadius, Ring.Radius);
+		ObjectQueryParams.AddObjectTypesToQuery(Ring.Channel);
+	}
+
+	// While predicting, the query also finds objects that could reach the rings before the next query
+	const float QueryRadius = Config->bPredictRadiusRings ? MaxRadius + Config->RadiusRingsMaxPredictedSpeed * Config->RadiusRingsUpdateInterval : MaxRadius;
+
+	// Owners that are close to each other can share the query. The shared query finds more objects than the owner's own query would, and both are refined with the same overlap test
+	const FVector Location = GetOwner()->GetActorLocation();
+	UPeripheryWorldSubsystem* PeripherySubsystem = GetWorld()->GetSubsystem<UPeripheryWorldSubsystem>();
+	TSharedPtr<const TArray<FOverlapResult>> SharedOverlaps;
+	TArray<FOverlapResult> Overlaps;
+	if (Config->bShareRadiusRingQueries && PeripherySubsystem)
+	{
+		SharedOverlaps = PeripherySubsystem->GetSharedOverlaps(Location, QueryRadius, ObjectQueryParams, Config->SharedQueryCellSize);
+	}
+	else
+	{
+		const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(PeripheryRadiusRings), false, GetOwner());
+		GetWorld()->OverlapMultiByObjectType(Overlaps, Location, FQuat::Identity, ObjectQueryParams, FCollisionShape::MakeSphere(QueryRadius), QueryParams);
+	}
+
+	// While predicting, the query only adds new candidates. The candidates that are already tracked are evaluated on their own schedule
+	if (Config->bPredictRadiusRings)
+	{
+		const double Time = GetWorld()->GetTimeSeconds();
+		for (TPair<TWeakObjectPtr<AActor>, FPeripheryRingCandidate>& Candidate : RadiusRingCandidates) Candidate.Value.bFound = false;
+
+		for (const FOverlapResult& Overlap : SharedOverlaps ? *SharedOverlaps : Overlaps)
 		{
-			// If this is a periphery object with custom logic, activate the functions
-			if (bPreviousActorPeripheryInterface) IPeripheryObjectInterface::Execute_OutsideOfPlayerTracePeriphery(PreviousTracedActor, Player, FindPeripheryType(PreviousTracedActor));
+			AActor* OtherActor = Overlap.GetActor();
+			UPrimitiveComponent* OtherComp = Overlap.GetComponent();
+			if (!OtherActor || !OtherComp || OtherActor == Player) continue;
 
-			// Periphery Trace delegates
-			ObjectOutsideOfPeripheryTrace.Broadcast(PreviousTracedActor, Player, TraceResult);
-		} 
+			FPeripheryRingCandidate* Candidate = RadiusRingCandidates.Find(OtherActor);
+			if (Candidate)
+			{
+				Candidate->bFound = true;
+				continue;
+			}
 
-		if (bIsTraceValidPeripheryObject)
+			Candidate = &RadiusRingCandidates.Add(OtherActor);
+			Candidate->Component = OtherComp;
+			Candidate->bFound = true;
+			EvaluateRadiusRingCandidate(OtherActor, *Candidate, Time);
+		}
+
+		// Candidates the query didn't find are too far away to be in any of the rings, so they're evaluated one last time for their exit events
+		for (auto It = RadiusRingCandidates.CreateIterator(); It; ++It)
 		{
-			// If this is a periphery object with custom logic, activate the functions
-			if (bPeripheryInterface) IPeripheryObjectInterface::Execute_WithinPlayerTracePeriphery(TracedActor, Player, FindPeripheryType(TracedActor));
+			if (It->Value.bFound) continue;
+			if (AActor* OtherActor = It->Key.Get()) EvaluateRadiusRingCandidate(OtherActor, It->Value, Time);
+			It.RemoveCurrent();
+		}
 
-			// Periphery Trace delegates
-			ObjectInPeripheryTrace.Broadcast(TracedActor, Player, TraceResult);
+		return;
+	}
+
+	// Check each of the objects against every ring
+	TArray<TSet<TWeakObjectPtr<AActor>>, TInlineAllocator<4>> CurrentRings;
+	CurrentRings.SetNum(Config->RadiusRings.Num());
+	for (const FOverlapResult& Overlap : SharedOverlaps ? *SharedOverlaps : Overlaps)
+	{
+		AActor* OtherActor = Overlap.GetActor();
+		const UPrimitiveComponent* OtherComp = Overlap.GetComponent();
+		if (!OtherActor || !OtherComp || OtherActor == Player) continue;
+
+		const ECollisionChannel ObjectType = OtherComp->GetCollisionObjectType();
+		for (int32 RingIndex = 0; RingIndex < Config->RadiusRings.Num(); RingIndex++)
+		{
+			const FPeripheryRadiusRing& Ring = Config->RadiusRings[RingIndex];
+			if (Ring.Channel != ObjectType || CurrentRings[RingIndex].Contains(OtherActor)) continue;
+			if (!IsWithinRadiusRing(OtherComp, Location, Ring.Radius)) continue;
+			if (IsValidRadiusRingObject(OtherActor, RingIndex)) CurrentRings[RingIndex].Add(OtherActor);
 		}
-		
-		if (bDebugPeripheryTrace)
+	}
+
+	// Ring transitions
+	for (int32 RingIndex = 0; RingIndex < Config->RadiusRings.Num(); RingIndex++)
+	{
+		TSet<TWeakObjectPtr<AActor>>& PreviousActors = ActorsInRadiusRings[RingIndex];
+		TSet<TWeakObjectPtr<AActor>>& CurrentActors = CurrentRings[RingIndex];
+
+		for (const TWeakObjectPtr<AActor>& Previous : PreviousActors)
 		{
-			UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Transitioned looking at {2}{3} to {4}{5}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()),
-				*GetNameSafe(PreviousTracedActor),
-				bPreviousActorPeripheryInterface ? "(PeripheryInt)" : "",
-				*GetNameSafe(TracedActor),
-				bPeripheryInterface ? "(PeripheryInt)" : ""
-			);
+			AActor* OtherActor = Previous.Get();
+			if (!OtherActor || CurrentActors.Contains(Previous)) continue;
+			HandleRadiusRingTransition(OtherActor, RingIndex, false);
+		}
+
+		for (const TWeakObjectPtr<AActor>& Current : CurrentActors)
+		{
+			AActor* OtherActor = Current.Get();
+			if (!OtherActor || PreviousActors.Contains(Current)) continue;
+			HandleRadiusRingTransition(OtherActor, RingIndex, true);
 		}
+
+		PreviousActors = MoveTemp(CurrentActors);
 	}
-	else
+}
+
+
+void UPlayerPeripheriesComponent::UpdateRadiusRingCandidates()
+{
+	if (!GetCharacter() || !GetWorld()) return;
+	const double Time = GetWorld()->GetTimeSeconds();
+
+	// Only the candidates that could have crossed a ring are due, everything else waits in the schedule
+	while (!RadiusRingSchedule.IsEmpty() && RadiusRingSchedule.HeapTop().Time <= Time)
+	{
+		FPeripheryRingEvaluation Evaluation;
+		RadiusRingSchedule.HeapPop(Evaluation, false);
+
+		// Candidates are rescheduled without removing their previous entries, so only the latest entry is used
+		AActor* OtherActor = Evaluation.Actor.Get();
+		FPeripheryRingCandidate* Candidate = RadiusRingCandidates.Find(Evaluation.Actor);
+		if (!OtherActor || !Candidate || Candidate->NextEvaluationTime != Evaluation.Time) continue;
+
+		EvaluateRadiusRingCandidate(OtherActor, *Candidate, Time);
+	}
+}
+
+
+void UPlayerPeripheriesComponent::EvaluateRadiusRingCandidate(AActor* OtherActor, FPeripheryRingCandidate& Candidate, const double Time)
+{
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	ActorsInRadiusRings.SetNum(Config->RadiusRings.Num());
+
+	// Candidates that lost their component can't be in any of the rings
+	const UPrimitiveComponent* OtherComp = Candidate.Component.Get();
+	if (!OtherComp)
 	{
-		const bool bPreviousActorPeripheryInterface = PreviousTracedActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
-		if (bIsPreviousTraceValidPeripheryObject)
+		for (int32 RingIndex = 0; RingIndex < Config->RadiusRings.Num(); RingIndex++)
 		{
-			// If this is a periphery object with custom logic, activate the functions
-			if (bPreviousActorPeripheryInterface) IPeripheryObjectInterface::Execute_OutsideOfPlayerTracePeriphery(PreviousTracedActor, Player, FindPeripheryType(PreviousTracedActor));
-			
-			// Periphery Trace delegates
-			ObjectOutsideOfPeripheryTrace.Broadcast(PreviousTracedActor, Player, TraceResult);
+			if (ActorsInRadiusRings[RingIndex].Remove(OtherActor)) HandleRadiusRingTransition(OtherActor, RingIndex, false);
 		}
-		
-		if (bDebugPeripheryTrace)
+		return;
+	}
+
+	const FVector Location = GetOwner()->GetActorLocation();
+	const FVector RelativeLocation = OtherComp->Bounds.Origin - Location;
+	const ECollisionChannel ObjectType = OtherComp->GetCollisionObjectType();
+	const float DistanceSquared = OtherComp->Bounds.GetBox().ComputeSquaredDistanceToPoint(Location);
+	const double Distance = FMath::Sqrt(DistanceSquared);
+	const double RelativeSpeed = (OtherActor->GetVelocity() - GetOwner()->GetVelocity()).Size();
+
+	double TimeUntilCrossing = Config->RadiusRingsUpdateInterval;
+	for (int32 RingIndex = 0; RingIndex < Config->RadiusRings.Num(); RingIndex++)
+	{
+		const FPeripheryRadiusRing& Ring = Config->RadiusRings[RingIndex];
+		if (Ring.Channel != ObjectType) continue;
+
+		TSet<TWeakObjectPtr<AActor>>& RingActors = ActorsInRadiusRings[RingIndex];
+		const bool bWithinRing = DistanceSquared <= FMath::Square(Ring.Radius) && IsWithinRadiusRing(OtherComp, Location, Ring.Radius);
+		const bool bWasWithinRing = RingActors.Contains(OtherActor);
+		if (bWithinRing && !bWasWithinRing)
 		{
-			if (bPreviousActorPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Stopped looking at {2}(PeripheryInt)", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()), *GetNameSafe(PreviousTracedActor));
-			else UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Stopped looking at {2}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()), *GetNameSafe(PreviousTracedActor));
+			if (IsValidRadiusRingObject(OtherActor, RingIndex))
+			{
+				RingActors.Add(OtherActor);
+				HandleRadiusRingTransition(OtherActor, RingIndex, true);
+			}
+		}
+		else if (!bWithinRing && bWasWithinRing)
+		{
+			RingActors.Remove(OtherActor);
+			HandleRadiusRingTransition(OtherActor, RingIndex, false);
 		}
+		else if (!bWithinRing && Candidate.bEvaluated
+			&& PeripheryDetection::SweptBoxWithinRadius(-Candidate.RelativeLocation, -RelativeLocation, OtherComp->Bounds.BoxExtent, Ring.Radius)
+			&& IsValidRadiusRingObject(OtherActor, RingIndex))
+		{
+			// The object passed through the ring between evaluations, so it still enters and leaves it
+			HandleRadiusRingTransition(OtherActor, RingIndex, true);
+			HandleRadiusRingTransition(OtherActor, RingIndex, false);
+		}
+
+		TimeUntilCrossing = PeripheryDetection::TimeUntilRadiusCrossing(Distance, Ring.Radius, RelativeSpeed, TimeUntilCrossing);
+	}
+
+	Candidate.RelativeLocation = RelativeLocation;
+	// Objects right on the edge of a ring are evaluated again next frame
+	Candidate.NextEvaluationTime = Time + FMath::Max(TimeUntilCrossing, UE_KINDA_SMALL_NUMBER);
+	Candidate.bEvaluated = true;
+	RadiusRingSchedule.HeapPush(FPeripheryRingEvaluation{Candidate.NextEvaluationTime, OtherActor});
+}
+
+
+bool UPlayerPeripheriesComponent::IsWithinRadiusRing(const UPrimitiveComponent* OtherComp, const FVector& Location, const float Radius) const
+{
+	const FBox Bounds = OtherComp->Bounds.GetBox();
+	if (Bounds.ComputeSquaredDistanceToPoint(Location) > FMath::Square(Radius)) return false;
+
+	// Objects whose bounds are entirely within the ring don't need their collision checked
+	const FVector FarthestCorner = (Location - Bounds.GetCenter()).GetAbs() + Bounds.GetExtent();
+	if (FarthestCorner.SizeSquared() <= FMath::Square(Radius)) return true;
+	return OtherComp->OverlapComponent(Location, FQuat::Identity, FCollisionShape::MakeSphere(Radius));
+}
+
+
+void UPlayerPeripheriesComponent::HandleRadiusRingTransition(AActor* OtherActor, const int32 RingIndex, const bool bEnter)
+{
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	const FName RingName = Config->RadiusRings.IsValidIndex(RingIndex) ? Config->RadiusRings[RingIndex].Name : NAME_None;
+
+	// If this is a periphery object with custom logic, activate the functions
+	const bool bPeripheryInterface = OtherActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
+	if (bEnter)
+	{
+		if (bPeripheryInterface) IPeripheryObjectInterface::Execute_WithinPlayerRadiusRing(OtherActor, Player, FindPeripheryType(OtherActor), RingIndex, RingName);
+
+		// Player logic
+		ObjectInRadiusRing.Broadcast(OtherActor, RingIndex, RingName);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_RadiusRing, true, RingIndex);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_RadiusRing, true, RingIndex);
+	}
+	else
+	{
+		if (bPeripheryInterface) IPeripheryObjectInterface::Execute_OutsideOfPlayerRadiusRing(OtherActor, Player, FindPeripheryType(OtherActor), RingIndex, RingName);
+
+		// Player logic
+		ObjectOutsideOfRadiusRing.Broadcast(OtherActor, RingIndex, RingName);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_RadiusRing, false, RingIndex);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_RadiusRing, false, RingIndex);
+	}
+
+	if (Config->bDebugRadiusRings)
+	{
+		UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Radius Ring {2}({3}), {4} {5} {6}{7}", *UEnum::GetValueAsString(Player->GetLocalRole()), bEnter ? "Entering" : "Exiting", RingIndex, *RingName.ToString(),
+			*GetNameSafe(OtherActor), bEnter ? "entered" : "left", *GetNameSafe(Player), bPeripheryInterface ? "(PeripheryInt)" : "");
 	}
-	
-	bIsPreviousTraceValidPeripheryObject = bIsTraceValidPeripheryObject;
-	PreviousTracedActor = TracedActor; // Cached for on exit traces
 }
 
 
@@ -303,8 +713,9 @@ void UPlayerPeripheriesComponent::OnEnterRadiusPeriphery(UPrimitiveComponent* Ov
 {
 	if (!GetCharacter() || !OtherActor) return;
 	if (OtherActor == Player) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (IsValidObjectInRadius(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
+	if (IsValidPeripheryObject(EPeripheryKind::EPK_Radius, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
 	{
 		// If this is a periphery object with custom logic, activate the functions
 		const bool bPeripheryInterface = OtherActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
@@ -312,8 +723,10 @@ void UPlayerPeripheriesComponent::OnEnterRadiusPeriphery(UPrimitiveComponent* Ov
 		
 		// Player logic
 		ObjectInPlayerRadius.Broadcast(OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_Radius, true);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_Radius, true);
 		
-		if (bDebugPeripheryRadius)
+		if (Config->bDebugPeripheryRadius)
 		{
 			if (bPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: Entering Radius Periphery, {1} overlapped with {2}(PeripheryInt)", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
 			else UE_LOGFMT(PeripheryLog, Verbose, "{0}: Entering Radius Periphery, {1} overlapped with {2}", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
@@ -326,8 +739,9 @@ void UPlayerPeripheriesComponent::OnExitRadiusPeriphery(UPrimitiveComponent* Ove
 {
 	if (!GetCharacter() || !OtherActor) return;
 	if (OtherActor == Player) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (IsValidObjectInRadius(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex))
+	if (IsValidPeripheryObject(EPeripheryKind::EPK_Radius, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex))
 	{
 		// If this is a periphery object with custom logic, activate the functions
 		const bool bPeripheryInterface = OtherActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
@@ -335,8 +749,10 @@ void UPlayerPeripheriesComponent::OnExitRadiusPeriphery(UPrimitiveComponent* Ove
 		
 		// Player logic
 		ObjectOutsideOfPlayerRadius.Broadcast(OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_Radius, false);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_Radius, false);
 		
-		if (bDebugPeripheryRadius)
+		if (Config->bDebugPeripheryRadius)
 		{
 			if (bPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: Exiting Radius Periphery, {1} overlapped with {2}(PeripheryInt)", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
 			UE_LOGFMT(PeripheryLog, Verbose, "{0}: Exiting Radius Periphery, {1} overlapped with {2}", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
@@ -349,8 +765,9 @@ void UPlayerPeripheriesComponent::OnEnterConePeriphery(UPrimitiveComponent* Over
 {
 	if (!GetCharacter() || !OtherActor) return;
 	if (OtherActor == Player) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (IsValidObjectInCone(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
+	if (IsValidPeripheryObject(EPeripheryKind::EPK_Cone, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
 	{
 		// If this is a periphery object with custom logic, activate the functions
 		const bool bPeripheryInterface = OtherActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
@@ -358,8 +775,10 @@ void UPlayerPeripheriesComponent::OnEnterConePeriphery(UPrimitiveComponent* Over
 		
 		// Player logic
 		ObjectInPeripheryCone.Broadcast(OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_Cone, true);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_Cone, true);
 	
-		if (bDebugPeripheryCone)
+		if (Config->bDebugPeripheryCone)
 		{
 			if (bPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: Entering Cone Periphery, {1} overlapped with {2}(PeripheryInt)", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
 			else UE_LOGFMT(PeripheryLog, Verbose, "{0}: Entering Cone Periphery, {1} overlapped with {2}", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
@@ -372,8 +791,9 @@ void UPlayerPeripheriesComponent::OnExitConePeriphery(UPrimitiveComponent* Overl
 {
 	if (!GetCharacter() || !OtherActor) return;
 	if (OtherActor == Player) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (IsValidObjectInCone(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex))
+	if (IsValidPeripheryObject(EPeripheryKind::EPK_Cone, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex))
 	{
 		// If this is a periphery object with custom logic, activate the functions
 		const bool bPeripheryInterface = OtherActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
@@ -381,8 +801,10 @@ void UPlayerPeripheriesComponent::OnExitConePeriphery(UPrimitiveComponent* Overl
 		
 		// Player logic
 		ObjectOutsideOfPeripheryCone.Broadcast(OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_Cone, false);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_Cone, false);
 
-		if (bDebugPeripheryCone)
+		if (Config->bDebugPeripheryCone)
 		{
 			if (bPeripheryInterface) UE_LOGFMT(PeripheryLog, Log, "{0}: Exiting Cone Periphery, {1} overlapped with {2}(PeripheryInt)", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
 			else UE_LOGFMT(PeripheryLog, Verbose, "{0}: Exiting Cone Periphery, {1} overlapped with {2}", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
@@ -395,13 +817,29 @@ void UPlayerPeripheriesComponent::OnEnterItemDetection(UPrimitiveComponent* Over
 {
 	if (!GetCharacter() || !OtherActor) return;
 	if (OtherActor == Player) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (IsValidItemDetected(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
+	// Instanced items are detected individually, instead of as their component's actor
+	const FPeripheryItemInstance Instance = FPeripheryItemInstance::Find(OtherComp, OtherBodyIndex);
+	if (Instance.IsSet())
+	{
+		if (!DetectedItemInstances.Contains(Instance) && IsValidPeripheryObject(EPeripheryKind::EPK_ItemDetection, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
+		{
+			BindItemInstanceRemoved(Instance.Component);
+			DetectedItemInstances.Add(Instance);
+			HandleItemInstanceTransition(Instance, EPeripheryKind::EPK_ItemDetection, true);
+		}
+		return;
+	}
+
+	if (IsValidPeripheryObject(EPeripheryKind::EPK_ItemDetection, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult))
 	{
 		// Player logic
 		OnItemOverlapBegin.Broadcast(OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_ItemDetection, true);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_ItemDetection, true);
 		
-		if (bDebugItemDetection)
+		if (Config->bDebugItemDetection)
 		{
 			UE_LOGFMT(PeripheryLog, Log, "{0}: Item detected, {1} overlapped with {2}", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
 		}
@@ -413,13 +851,32 @@ void UPlayerPeripheriesComponent::OnExitItemDetection(UPrimitiveComponent* Overl
 {
 	if (!GetCharacter() || !OtherActor) return;
 	if (OtherActor == Player) return;
+	const UPeripheryConfig* Config = GetPeripheryConfig();
 
-	if (IsValidItemDetected(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex))
+	// Removed instances (picked up) have already left through OnItemInstanceRemoved(), so this only matches the item that's currently at the instance's index
+	if (const UPeripheryItemInstancesComponent* ItemInstances = Cast<UPeripheryItemInstancesComponent>(OtherComp))
+	{
+		const int32 ItemId = ItemInstances->GetItemId(OtherBodyIndex);
+		const int32 DetectedIndex = DetectedItemInstances.IndexOfByPredicate([ItemInstances, ItemId](const FPeripheryItemInstance& Detected)
+		{
+			return Detected.Component == ItemInstances && Detected.ItemId == ItemId;
+		});
+		if (DetectedIndex == INDEX_NONE) return;
+
+		const FPeripheryItemInstance Instance = DetectedItemInstances[DetectedIndex];
+		DetectedItemInstances.RemoveAtSwap(DetectedIndex);
+		HandleItemInstanceTransition(Instance, EPeripheryKind::EPK_ItemDetection, false);
+		return;
+	}
+
+	if (IsValidPeripheryObject(EPeripheryKind::EPK_ItemDetection, OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex))
 	{
 		// Player logic
 		OnItemOverlapEnd.Broadcast(OtherActor, OverlappedComponent, OtherComp, OtherBodyIndex);
+		PublishPeripheryEvent(OtherActor, EPeripheryKind::EPK_ItemDetection, false);
+		UpdatePeripheryHighlight(OtherActor, EPeripheryKind::EPK_ItemDetection, false);
 		
-		if (bDebugItemDetection)
+		if (Config->bDebugItemDetection)
 		{
 			UE_LOGFMT(PeripheryLog, Log, "{0}: Item undetected, {1} overlapped with {2}", *UEnum::GetValueAsString(Player->GetLocalRole()), *GetNameSafe(Player), *GetNameSafe(OtherActor));
 		}
@@ -427,37 +884,292 @@ void UPlayerPeripheriesComponent::OnExitItemDetection(UPrimitiveComponent* Overl
 }
 
 
-bool UPlayerPeripheriesComponent::IsValidObjectInRadius_Implementation(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+void UPlayerPeripheriesComponent::OnItemInstanceRemoved(UPeripheryItemInstancesComponent* Component, const int32 ItemId, const int32 RemovedIndex, const int32 MovedFromIndex)
+{
+	// The events can change the detected instances, so the index is checked each time
+	for (int32 DetectedIndex = DetectedItemInstances.Num() - 1; DetectedIndex >= 0; DetectedIndex--)
+	{
+		if (!DetectedItemInstances.IsValidIndex(DetectedIndex)) continue;
+		FPeripheryItemInstance& Detected = DetectedItemInstances[DetectedIndex];
+		if (Detected.Component != Component) continue;
+
+		if (Detected.ItemId == ItemId)
+		{
+			const FPeripheryItemInstance Instance = Detected;
+			DetectedItemInstances.RemoveAtSwap(DetectedIndex);
+			HandleItemInstanceTransition(Instance, EPeripheryKind::EPK_ItemDetection, false);
+		}
+		else if (Detected.InstanceIndex == MovedFromIndex)
+		{
+			Detected.InstanceIndex = RemovedIndex;
+		}
+	}
+
+	if (TracedItemInstance.Component == Component)
+	{
+		if (TracedItemInstance.ItemId == ItemId)
+		{
+			const FPeripheryItemInstance Instance = TracedItemInstance;
+			TracedItemInstance = FPeripheryItemInstance();
+			HandleItemInstanceTransition(Instance, EPeripheryKind::EPK_Trace, false);
+		}
+		else if (TracedItemInstance.InstanceIndex == MovedFromIndex)
+		{
+			TracedItemInstance.InstanceIndex = RemovedIndex;
+		}
+	}
+}
+
+
+void UPlayerPeripheriesComponent::BindItemInstanceRemoved(UPeripheryItemInstancesComponent* Component)
+{
+	if (Component && !Component->OnItemInstanceRemoved.IsBoundToObject(this))
+	{
+		Component->OnItemInstanceRemoved.AddUObject(this, &UPlayerPeripheriesComponent::OnItemInstanceRemoved);
+	}
+}
+
+
+void UPlayerPeripheriesComponent::HandleItemInstanceTransition(const FPeripheryItemInstance& Instance, const EPeripheryKind Kind, const bool bEnter)
+{
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	AActor* OtherActor = Instance.Component ? Instance.Component->GetOwner() : nullptr;
+	if (!OtherActor) return;
+
+	// If the instances belong to a periphery object with custom logic, activate the functions
+	const bool bPeripheryInterface = OtherActor->GetClass()->ImplementsInterface(UPeripheryObjectInterface::StaticClass());
+	if (bEnter)
+	{
+		if (bPeripheryInterface) IPeripheryObjectInterface::Execute_WithinPlayerItemInstance(OtherActor, Player, Instance, Kind);
+
+		// Player logic
+		if (Kind == EPeripheryKind::EPK_Trace) ItemInstanceInPeripheryTrace.Broadcast(Instance, Player);
+		else OnItemInstanceOverlapBegin.Broadcast(Instance, Player);
+	}
+	else
+	{
+		if (bPeripheryInterface) IPeripheryObjectInterface::Execute_OutsideOfPlayerItemInstance(OtherActor, Player, Instance, Kind);
+
+		// Player logic
+		if (Kind == EPeripheryKind::EPK_Trace) ItemInstanceOutsideOfPeripheryTrace.Broadcast(Instance, Player);
+		else OnItemInstanceOverlapEnd.Broadcast(Instance, Player);
+	}
+
+	PublishPeripheryEvent(OtherActor, Kind, bEnter, INDEX_NONE, Instance.ItemId);
+	UpdatePeripheryHighlight(OtherActor, Kind, bEnter, INDEX_NONE, Instance.ItemId);
+
+	if ((Kind == EPeripheryKind::EPK_Trace && Config->bDebugPeripheryTrace) || (Kind == EPeripheryKind::EPK_ItemDetection && Config->bDebugItemDetection))
+	{
+		UE_LOGFMT(PeripheryLog, Log, "{0}: {1} Item instance {2} of {3} {4} the {5}", *UEnum::GetValueAsString(GetOwner()->GetLocalRole()), *GetNameSafe(GetOwner()),
+			Instance.ItemId, *GetNameSafe(OtherActor), bEnter ? "entered" : "left", *UEnum::GetDisplayValueAsText(Kind).ToString());
+	}
+}
+
+
+bool UPlayerPeripheriesComponent::IsValidPeripheryObject(const EPeripheryKind Kind, AActor* OtherActor, UPrimitiveComponent* OverlappedComponent, UPrimitiveComponent* OtherComp, const int32 OtherBodyIndex, const bool bFromSweep, const FHitResult& SweepResult)
 {
 	if (!OtherActor) return false;
-	return OtherActor->GetClass()->IsChildOf(ValidPeripheryRadiusObjects);
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+
+	// The filter handles the common checks natively, so most objects never reach the validators
+	const EPeripheryType PeripheryType = Config->FilterUsesPeripheryTypes(Kind) ? FindRegisteredPeripheryType(OtherActor) : EPeripheryType::EPT_None;
+	if (!Config->PassesFilter(Kind, OtherActor, PeripheryType)) return false;
+
+	// Validators that aren't overridden in blueprint are called natively, which still uses any C++ overrides
+	if (ScriptValidators & (1 << (uint8)Kind))
+	{
+		switch (Kind)
+		{
+			case EPeripheryKind::EPK_Radius: return IsValidObjectInRadius(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+			case EPeripheryKind::EPK_Cone: return IsValidObjectInCone(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+			case EPeripheryKind::EPK_Trace: return IsValidTracedObject(OtherActor, SweepResult);
+			case EPeripheryKind::EPK_ItemDetection: return IsValidItemDetected(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+			default: return true;
+		}
+	}
+
+	switch (Kind)
+	{
+		case EPeripheryKind::EPK_Radius: return IsValidObjectInRadius_Implementation(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+		case EPeripheryKind::EPK_Cone: return IsValidObjectInCone_Implementation(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+		case EPeripheryKind::EPK_Trace: return IsValidTracedObject_Implementation(OtherActor, SweepResult);
+		case EPeripheryKind::EPK_ItemDetection: return IsValidItemDetected_Implementation(OverlappedComponent, OtherActor, OtherComp, OtherBodyIndex, bFromSweep, SweepResult);
+		default: return true;
+	}
 }
 
-bool UPlayerPeripheriesComponent::IsValidTracedObject_Implementation(AActor* OtherActor, const FHitResult& HitResult)
+bool UPlayerPeripheriesComponent::IsValidRadiusRingObject(AActor* OtherActor, const int32 RingIndex)
 {
 	if (!OtherActor) return false;
-	return OtherActor->GetClass()->IsChildOf(ValidPeripheryTraceObjects);
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+
+	const EPeripheryType PeripheryType = Config->FilterUsesPeripheryTypes(EPeripheryKind::EPK_RadiusRing, RingIndex) ? FindRegisteredPeripheryType(OtherActor) : EPeripheryType::EPT_None;
+	if (!Config->PassesFilter(EPeripheryKind::EPK_RadiusRing, OtherActor, PeripheryType, RingIndex)) return false;
+
+	if (ScriptValidators & (1 << (uint8)EPeripheryKind::EPK_RadiusRing)) return IsValidObjectInRadiusRing(OtherActor, RingIndex);
+	return IsValidObjectInRadiusRing_Implementation(OtherActor, RingIndex);
+}
+
+bool UPlayerPeripheriesComponent::IsValidObjectInRadius_Implementation(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
+{
+	// The radius filter has already checked the object, this is only for custom logic
+	return OtherActor != nullptr;
+}
+
+bool UPlayerPeripheriesComponent::IsValidObjectInRadiusRing_Implementation(AActor* OtherActor, int32 RingIndex)
+{
+	// The ring's filter has already checked the object, this is only for custom logic
+	return OtherActor != nullptr;
+}
+
+bool UPlayerPeripheriesComponent::IsValidTracedObject_Implementation(AActor* OtherActor, const FHitResult& HitResult)
+{
+	// The trace filter has already checked the object, this is only for custom logic
+	return OtherActor != nullptr;
 }
 
 bool UPlayerPeripheriesComponent::IsValidObjectInCone_Implementation(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	if (!OtherActor) return false;
-	return OtherActor->GetClass()->IsChildOf(ValidPeripheryRadiusObjects);
+	// The cone filter has already checked the object, this is only for custom logic
+	return OtherActor != nullptr;
 }
 
 bool UPlayerPeripheriesComponent::IsValidItemDetected_Implementation(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
 {
-	if (!OtherActor) return false;
-	return OtherActor->GetClass()->IsChildOf(ValidPeripheryRadiusObjects);
+	// The item detection filter has already checked the object, this is only for custom logic
+	return OtherActor != nullptr;
 }
 #pragma endregion
 
 
 
+FPeripheryAimRay UPlayerPeripheriesComponent::GetPeripheryAimRay() const
+{
+	// The aim ray is shared between every periphery component using the same controller, and is only calculated once per frame
+	UPeripheryWorldSubsystem* PeripherySubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryWorldSubsystem>() : nullptr;
+	return PeripherySubsystem
+		? PeripherySubsystem->GetAimRay(GetOwner())
+		: UPeripheryWorldSubsystem::CalculateAimRay(GetOwner(), UPeripheryWorldSubsystem::FindViewController(GetOwner()));
+}
+
+
+void UPlayerPeripheriesComponent::RecordPeriphery(FPeripheryRecorder& Recorder)
+{
+	if (!GetOwner()) return;
+
+	const FPeripheryAimRay AimRay = GetPeripheryAimRay();
+	FPeripheryRecordedOwner Owner;
+	Owner.Location = FVector3f(GetOwner()->GetActorLocation());
+	Owner.Rotation = FQuat4f(GetOwner()->GetActorQuat());
+	Owner.AimOrigin = FVector3f(AimRay.Origin);
+	Owner.AimDirection = FVector3f(AimRay.Direction);
+	Owner.Radius = PeripheryRadius ? PeripheryRadius->GetScaledSphereRadius() : 0;
+	Owner.TracedActorId = Recorder.GetActorId(TracedActor);
+	if (PeripheryCone && PeripheryCone->GetStaticMesh())
+	{
+		// The cone is along the mesh's forward axis, with the tip at the back of it's bounds and the base at the front
+		const FBox LocalBounds = PeripheryCone->GetStaticMesh()->GetBoundingBox();
+		const FVector Scale = PeripheryCone->GetComponentScale().GetAbs();
+		const FVector LocalCenter = LocalBounds.GetCenter();
+		const float ConeLength = LocalBounds.GetSize().X * Scale.X;
+		const float ConeBaseRadius = FMath::Max(LocalBounds.GetExtent().Y * Scale.Y, LocalBounds.GetExtent().Z * Scale.Z);
+
+		Owner.ConeOrigin = FVector3f(PeripheryCone->GetComponentTransform().TransformPosition(FVector(LocalBounds.Min.X, LocalCenter.Y, LocalCenter.Z)));
+		Owner.ConeDirection = FVector3f(PeripheryCone->GetForwardVector());
+		Owner.ConeLength = ConeLength;
+		Owner.ConeCosHalfAngle = FMath::Cos(FMath::Atan2(ConeBaseRadius, ConeLength));
+	}
+
+	if (bRadius) Owner.Flags |= PeripheryRecording::OF_Radius;
+	if (bCone) Owner.Flags |= PeripheryRecording::OF_Cone;
+	if (bTrace) Owner.Flags |= PeripheryRecording::OF_Trace;
+	if (TracedActor && bIsPreviousTraceValidPeripheryObject) Owner.Flags |= PeripheryRecording::OF_TracedValid;
+
+	// The candidates are everything that's currently overlapping the peripheries
+	TArray<AActor*> Candidates;
+	TArray<AActor*> OverlappingActors;
+	if (bRadius && PeripheryRadius)
+	{
+		PeripheryRadius->GetOverlappingActors(OverlappingActors);
+		Candidates.Append(OverlappingActors);
+	}
+	if (bCone && PeripheryCone)
+	{
+		PeripheryCone->GetOverlappingActors(OverlappingActors);
+		for (AActor* Actor : OverlappingActors) Candidates.AddUnique(Actor);
+	}
+
+	Recorder.RecordOwner(GetOwner(), Owner, Candidates, [this](AActor* Candidate)
+	{
+		uint32 Flags = 0;
+		if (IsValidPeripheryObject(EPeripheryKind::EPK_Radius, Candidate)) Flags |= PeripheryRecording::CF_ValidRadiusObject;
+		if (IsValidPeripheryObject(EPeripheryKind::EPK_Cone, Candidate)) Flags |= PeripheryRecording::CF_ValidConeObject;
+		return Flags;
+	});
+}
+
+
+void UPlayerPeripheriesComponent::FindScriptValidators()
+{
+	const UClass* Class = GetClass();
+	ScriptValidators = 0;
+	if (Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UPlayerPeripheriesComponent, IsValidObjectInRadius))) ScriptValidators |= 1 << (uint8)EPeripheryKind::EPK_Radius;
+	if (Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UPlayerPeripheriesComponent, IsValidObjectInCone))) ScriptValidators |= 1 << (uint8)EPeripheryKind::EPK_Cone;
+	if (Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UPlayerPeripheriesComponent, IsValidTracedObject))) ScriptValidators |= 1 << (uint8)EPeripheryKind::EPK_Trace;
+	if (Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UPlayerPeripheriesComponent, IsValidItemDetected))) ScriptValidators |= 1 << (uint8)EPeripheryKind::EPK_ItemDetection;
+	if (Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(UPlayerPeripheriesComponent, IsValidObjectInRadiusRing))) ScriptValidators |= 1 << (uint8)EPeripheryKind::EPK_RadiusRing;
+}
+
+
+void UPlayerPeripheriesComponent::PublishPeripheryEvent(const AActor* OtherActor, const EPeripheryKind Kind, const bool bEnter, const int32 RingIndex, const int32 ItemId) const
+{
+	const UPeripheryWorldSubsystem* PeripherySubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryWorldSubsystem>() : nullptr;
+	if (!PeripherySubsystem || !PeripherySubsystem->HasEventChannels()) return;
+
+	const UPeripheryObjectRegistry* Registry = GetWorld()->GetSubsystem<UPeripheryObjectRegistry>();
+	FPeripheryEventRecord Record;
+	Record.OwnerId = GetOwner() ? GetOwner()->GetUniqueID() : 0;
+	Record.ObjectId = OtherActor ? OtherActor->GetUniqueID() : 0;
+	Record.Handle = Registry ? Registry->FindHandle(OtherActor) : FPeripheryHandle();
+	Record.Timestamp = GetWorld()->GetTimeSeconds();
+	Record.RingIndex = RingIndex;
+	Record.ItemId = ItemId;
+	Record.Kind = Kind;
+	Record.bEnter = bEnter;
+	PeripherySubsystem->PublishEvent(Record);
+}
+
+
+void UPlayerPeripheriesComponent::UpdatePeripheryHighlight(AActor* OtherActor, const EPeripheryKind Kind, const bool bEnter, const int32 RingIndex, const int32 ItemId)
+{
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	if (!OtherActor || !(Config->HighlightPeripheries & (1 << (uint8)Kind))) return;
+
+	// Only the local player's peripheries are highlighted, the other players' peripheries (and the server's copies of them) shouldn't highlight what they find
+	if (!Player || !Player->IsLocallyControlled()) return;
+
+	UPeripheryHighlightSubsystem* HighlightSubsystem = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryHighlightSubsystem>() : nullptr;
+	if (!HighlightSubsystem) return;
+
+	// Each periphery (and each radius ring or item instance) is a separate request, so the object stays highlighted until it's left all of them
+	const int32 Source = (uint8)Kind | (int32)((uint32)((ItemId != INDEX_NONE ? ItemId : RingIndex) + 1) << 8);
+	const int32* StencilValue = bEnter ? Config->HighlightStencilValues.Find(FindPeripheryType(OtherActor)) : nullptr;
+	HighlightSubsystem->SetHighlight(OtherActor, this, Source, bEnter, StencilValue ? *StencilValue : Config->DefaultHighlightStencilValue);
+}
+
+
 EPeripheryType UPlayerPeripheriesComponent::FindPeripheryType(TScriptInterface<IPeripheryObjectInterface> PeripheryObject) const
 {
 	// Override this logic to determine the periphery type of an object within the player's periphery
-	return EPeripheryType::EPT_None;
+	return FindRegisteredPeripheryType(Cast<AActor>(PeripheryObject.GetObject()));
+}
+
+
+EPeripheryType UPlayerPeripheriesComponent::FindRegisteredPeripheryType(const AActor* Actor) const
+{
+	const UPeripheryObjectRegistry* Registry = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	const int32 PackedIndex = Registry ? Registry->GetPackedIndex(Registry->FindHandle(Actor)) : INDEX_NONE;
+	return PackedIndex != INDEX_NONE ? Registry->GetTypes()[PackedIndex] : EPeripheryType::EPT_None;
 }
 
 
@@ -491,6 +1203,39 @@ TScriptInterface<IPeripheryObjectInterface> UPlayerPeripheriesComponent::GetTrac
 	return TracedActor;
 }
 
+FPeripheryHandle UPlayerPeripheriesComponent::GetTracedHandle() const
+{
+	return TracedHandle;
+}
+
+FPeripheryItemInstance UPlayerPeripheriesComponent::GetTracedItemInstance() const
+{
+	return TracedItemInstance;
+}
+
+FPeripheryTraceClaim UPlayerPeripheriesComponent::CreateTraceClaim() const
+{
+	const UPeripheryConfig* Config = GetPeripheryConfig();
+	const FPeripheryAimRay AimRay = GetPeripheryAimRay();
+
+	// The server compares the claim against it's history, so the timestamp is the client's estimate of the server's time
+	FPeripheryTraceClaim Claim;
+	Claim.Owner = GetOwner();
+	Claim.Target = TracedActor;
+	Claim.Origin = AimRay.Origin + (AimRay.Direction * Config->PeripheryTraceForwardOffset);
+	Claim.Direction = AimRay.Direction;
+	const AGameStateBase* GameState = GetWorld() ? GetWorld()->GetGameState() : nullptr;
+	Claim.Timestamp = GameState ? GameState->GetServerWorldTimeSeconds() : (GetWorld() ? GetWorld()->GetTimeSeconds() : 0);
+	return Claim;
+}
+
+const UPeripheryConfig* UPlayerPeripheriesComponent::GetPeripheryConfig() const
+{
+	if (PeripheryConfigOverride) return PeripheryConfigOverride;
+	if (PeripheryConfig) return PeripheryConfig;
+	return GetDefault<UPeripheryConfig>();
+}
+
 USphereComponent* UPlayerPeripheriesComponent::GetPeripheryRadius()
 {
 	return PeripheryRadius;
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryHighlightSubsystem.h"
+#include "Components/StaticMeshComponent.h"
+#include "Engine/World.h"
+#include "Misc/AutomationTest.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPeripheryHighlightStatsTest, "PeripherySystem.Highlight.Stats", EAutomationTestFlags::EditorContext | EAutomationTestFlags::ProductFilter)
+bool FPeripheryHighlightStatsTest::RunTest(const FString& Parameters)
+{
+	UWorld* World = UWorld::CreateWorld(EWorldType::Game, false);
+	UPeripheryHighlightSubsystem* HighlightSubsystem = World->GetSubsystem<UPeripheryHighlightSubsystem>();
+	if (!TestNotNull(TEXT("The highlight subsystem exists"), HighlightSubsystem))
+	{
+		World->DestroyWorld(false);
+		return false;
+	}
+
+	AActor* Target = World->SpawnActor<AActor>();
+	NewObject<UStaticMeshComponent>(Target);
+	const AActor* FirstObserver = World->SpawnActor<AActor>();
+	const AActor* SecondObserver = World->SpawnActor<AActor>();
+
+	// Objects that enter and leave during the same frame are never changed
+	HighlightSubsystem->SetHighlight(Target, FirstObserver, 0, true);
+	HighlightSubsystem->SetHighlight(Target, FirstObserver, 0, false);
+	HighlightSubsystem->ApplyHighlights();
+	FPeripheryHighlightStats Stats = HighlightSubsystem->GetStats();
+	TestEqual(TEXT("Coalesced requests"), Stats.NumRequests, 2);
+	TestEqual(TEXT("Coalesced state changes"), Stats.NumStateChanges, 0);
+	TestEqual(TEXT("Coalesced skipped changes"), Stats.NumSkippedChanges, 1);
+	TestEqual(TEXT("Coalesced component updates"), Stats.NumComponentUpdates, 0);
+	TestFalse(TEXT("Coalesced target isn't highlighted"), HighlightSubsystem->IsHighlighted(Target));
+
+	// Repeated requests don't mark the object as changed
+	HighlightSubsystem->ResetStats();
+	HighlightSubsystem->SetHighlight(Target, FirstObserver, 0, true);
+	HighlightSubsystem->SetHighlight(Target, FirstObserver, 0, true);
+	HighlightSubsystem->ApplyHighlights();
+	HighlightSubsystem->SetHighlight(Target, FirstObserver, 0, true);
+	HighlightSubsystem->ApplyHighlights();
+	Stats = HighlightSubsystem->GetStats();
+	TestEqual(TEXT("Repeated requests"), Stats.NumRequests, 3);
+	TestEqual(TEXT("Repeated state changes"), Stats.NumStateChanges, 1);
+	TestEqual(TEXT("Repeated skipped changes"), Stats.NumSkippedChanges, 0);
+	TestEqual(TEXT("Repeated component updates"), Stats.NumComponentUpdates, 1);
+	TestEqual(TEXT("Repeated highlight requests"), HighlightSubsystem->GetNumHighlightRequests(Target), 1);
+
+	// The object stays highlighted until every request has been removed
+	HighlightSubsystem->ResetStats();
+	HighlightSubsystem->SetHighlight(Target, SecondObserver, 0, true);
+	HighlightSubsystem->ApplyHighlights();
+	HighlightSubsystem->SetHighlight(Target, FirstObserver, 0, false);
+	HighlightSubsystem->ApplyHighlights();
+	TestTrue(TEXT("Target is highlighted while it has a request"), HighlightSubsystem->IsHighlighted(Target));
+	HighlightSubsystem->SetHighlight(Target, SecondObserver, 0, false);
+	HighlightSubsystem->ApplyHighlights();
+	Stats = HighlightSubsystem->GetStats();
+	TestEqual(TEXT("Counted requests"), Stats.NumRequests, 3);
+	TestEqual(TEXT("Counted state changes"), Stats.NumStateChanges, 1);
+	TestEqual(TEXT("Counted skipped changes"), Stats.NumSkippedChanges, 2);
+	TestEqual(TEXT("Counted component updates"), Stats.NumComponentUpdates, 1);
+	TestFalse(TEXT("Target isn't highlighted once every request is removed"), HighlightSubsystem->IsHighlighted(Target));
+
+	World->DestroyWorld(false);
+	return true;
+}
+
+
+#endif
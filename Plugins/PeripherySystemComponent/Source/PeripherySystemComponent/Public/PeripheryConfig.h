@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryFilter.h"
+#include "PeripheryTypes.h"
+#include "Engine/DataAsset.h"
+#include "Kismet/KismetSystemLibrary.h"
+#include "PeripheryConfig.generated.h"
+
+
+/**
+ *	A radius ring of the periphery component. Every ring is checked against the same proximity query, so you can have multiple awareness bands (melee, target lock, radar) without multiple overlap spheres
+ */
+USTRUCT(BlueprintType)
+struct FPeripheryRadiusRing
+{
+	GENERATED_BODY()
+
+	/** The name of the ring, this is passed to the ring delegates */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius Rings") FName Name;
+	
+	/** The radius of the ring */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius Rings") float Radius = 1000;
+	
+	/** The collision channel of the objects this ring searches for */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius Rings") TEnumAsByte<ECollisionChannel> Channel = ECC_Pawn;
+	
+	/** The objects this ring searches for. You can also override IsValidObjectInRadiusRing() for custom logic to search for different things */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius Rings") FPeripheryFilter Filter;
+};
+
+
+/**
+ * The tuning for a periphery component (channels, filters, trace settings, radius rings and debugging). \n\n
+ * Every character of the same archetype should reference the same config, so the components only carry a pointer to it along with their own periphery state.
+ * Components can also use an instanced config to override the settings for a specific character
+ *
+ * @remark Which peripheries are used, and when they're activated, is still set on the component
+ */
+UCLASS(BlueprintType, EditInlineNew)
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryConfig : public UPrimaryDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	/**** Periphery Radius ****/
+	/** The collision channel for the periphery radius sphere */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius") TEnumAsByte<ECollisionChannel> PeripheryRadiusChannel;
+
+	/** The objects the periphery radius searches for. You can also override IsValidObjectInRadius() for custom logic to search for different things */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius") FPeripheryFilter RadiusFilter;
+
+	/** Debug the periphery radius functions */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius") bool bDebugPeripheryRadius;
+
+
+	/**** Radius Rings ****/
+	/** The radius rings (for things like melee, target lock and radar ranges). Every ring uses the same proximity query, which is a lot cheaper than multiple periphery radiuses */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings", meta = (TitleProperty = "Name")) TArray<FPeripheryRadiusRing> RadiusRings;
+
+	/** How often the radius rings are updated, in seconds. If this is zero they're updated every frame */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings", meta = (ClampMin = "0")) float RadiusRingsUpdateInterval;
+
+	/**
+	 * Whether owners that are close to each other should share their proximity query (for things like squads of ai). Every owner within the same cell with the same rings uses one query for the frame,
+	 * and refines the results for it's own rings. The updates are also aligned to the update interval so owners update on the same frames
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings") bool bShareRadiusRingQueries;
+
+	/** The size of the cells for sharing proximity queries. Larger cells share more queries, but the shared query has to cover the entire cell */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings", meta = (EditCondition = "bShareRadiusRingQueries", EditConditionHides, ClampMin = "1")) float SharedQueryCellSize;
+
+	/**
+	 * Whether the radius rings predict when objects could cross them from their velocity relative to the owner. The proximity query only finds new objects at the update interval,
+	 * and each object is evaluated again once it could first cross one of the rings, so objects that are far from the rings are rarely evaluated. Objects that pass through a ring between evaluations are caught with swept tests
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings") bool bPredictRadiusRings;
+
+	/** The fastest relative speed of new objects the prediction should catch. The proximity query is expanded by how far they can move within the update interval, so they're found before they reach the rings */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings", meta = (EditCondition = "bPredictRadiusRings", EditConditionHides, ClampMin = "0")) float RadiusRingsMaxPredictedSpeed;
+
+	/** Debug the radius rings functions */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Radius Rings") bool bDebugRadiusRings;
+
+
+	/**** Item Detection ****/
+	/** The collision channel for the item detection sphere */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Detection") TEnumAsByte<ECollisionChannel> ItemDetectionChannel;
+
+	/** The objects the item detection sphere searches for. You can also override IsValidItemDetected() for custom logic to search for different things */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Detection") FPeripheryFilter ItemDetectionFilter;
+
+	/** Debug the item detection functions */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Item Detection") bool bDebugItemDetection;
+
+
+	/**** Periphery Cone ****/
+	/** The collision channel for the periphery cone */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cone") TEnumAsByte<ECollisionChannel> PeripheryConeChannel;
+
+	/** The objects the periphery cone searches for. You can also override IsValidObjectInCone() for custom logic to search for different things */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cone") FPeripheryFilter ConeFilter;
+
+	/** Debug the periphery cone functions */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Cone") bool bDebugPeripheryCone;
+
+
+	/**** Periphery Trace ****/
+	/** The object types the periphery trace searches for */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") TArray<TEnumAsByte<EObjectTypeQuery>> PeripheryLineTraceObjectTypes;
+
+	/** The objects the periphery trace searches for. You can also override IsValidTracedObject() for custom logic to search for different things */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") FPeripheryFilter TraceFilter;
+
+	/** The distance of the trace */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") float PeripheryTraceDistance;
+
+	/** The offset is to help with things like third person camera adjustments so it doesn't trace over the character */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") float PeripheryTraceForwardOffset;
+
+	/**
+	 * Whether the trace is only performed when the aim ray passes through the bounds of a registered periphery object, and only up to the farthest of them.
+	 * On open maps most frames don't need to trace at all, but anything that isn't in the periphery object registry can't be traced while this is enabled
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") bool bPrefilterTrace;
+
+	/** Whether the trace should ignore the owner's actors, which are captured during begin play (if this is set to true) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") bool TraceShouldIgnoreOwnerActors;
+
+	/** Debug the periphery trace functions */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") bool bDebugPeripheryTrace;
+
+	/** Draw the debug trace */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace") bool bDrawTraceDebug;
+
+	/** The color of the trace */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace", meta = (EditCondition = "bDrawTraceDebug", EditConditionHides)) FColor TraceColor = FColor::Emerald;
+
+	/** The color of the trace when it finds something */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace", meta = (EditCondition = "bDrawTraceDebug", EditConditionHides)) FColor TraceHitColor = FColor::Emerald;
+
+	/** The duration of the trace */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Trace", meta = (EditCondition = "bDrawTraceDebug", EditConditionHides)) float TraceDuration = 0.1;
+
+
+	/**** Highlight ****/
+	/** The peripheries that highlight the objects they find, for locally controlled players. The highlights are handled by the periphery highlight subsystem, which applies every change once per frame */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Highlight", meta = (Bitmask, BitmaskEnum = "/Script/PeripherySystemComponent.EPeripheryKind")) int32 HighlightPeripheries;
+
+	/** The custom depth stencil value for each periphery type, for highlighting them with different colors */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Highlight") TMap<EPeripheryType, int32> HighlightStencilValues;
+
+	/** The stencil value for periphery types that aren't in HighlightStencilValues */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Highlight", meta = (ClampMin = "0", ClampMax = "255")) int32 DefaultHighlightStencilValue;
+
+
+public:
+	UPeripheryConfig();
+	virtual FPrimaryAssetId GetPrimaryAssetId() const override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	/** Returns the filter for one of the peripheries (or one of the radius rings), or nullptr if the periphery doesn't have one */
+	const FPeripheryFilter* GetFilter(EPeripheryKind Kind, int32 RingIndex = INDEX_NONE) const;
+
+	/** Whether an object passes the filter for one of the peripheries (or one of the radius rings). This only uses the compiled filter, the component handles the validators */
+	bool PassesFilter(EPeripheryKind Kind, const AActor* Actor, EPeripheryType PeripheryType, int32 RingIndex = INDEX_NONE) const;
+
+	/** Whether the filter for one of the peripheries (or one of the radius rings) checks the periphery type */
+	bool FilterUsesPeripheryTypes(EPeripheryKind Kind, int32 RingIndex = INDEX_NONE) const;
+
+	/** Compiles the filters, indexed by periphery kind with the radius rings after them. This needs to be called after changing the filters outside of the editor */
+	void CompileFilters() const;
+
+
+protected:
+	/** The filters compiled for each periphery kind and radius ring. These are compiled the first time they're used, and again whenever the config is edited */
+	mutable FPeripheryCompiledFilters CompiledFilters;
+
+	/** Returns the compiled filter index of a periphery kind, or one of the radius rings. Rings past the most filters that can be compiled don't have one */
+	static int32 GetFilterIndex(EPeripheryKind Kind, int32 RingIndex);
+
+
+};
@@ -0,0 +1,155 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+
+
+/**
+ * The periphery detection logic without any of the world or actor dependencies. \n\n
+ * The periphery component and the offline replay both use this, so the results of a recorded match are the same as the events that were created during the match
+ */
+namespace PeripheryDetection
+{
+	/** Whether a location is within a periphery radius */
+	FORCEINLINE bool IsWithinRadius(const FVector& Origin, const FVector& Location, const float Radius)
+	{
+		return FVector::DistSquared(Origin, Location) <= FMath::Square(Radius);
+	}
+
+	/** Whether a box is within a periphery radius, which is how the radius overlaps something's collision */
+	FORCEINLINE bool IsBoxWithinRadius(const FVector& Origin, const FVector& BoxCenter, const FVector& BoxExtent, const float Radius)
+	{
+		return FBox(BoxCenter - BoxExtent, BoxCenter + BoxExtent).ComputeSquaredDistanceToPoint(Origin) <= FMath::Square(Radius);
+	}
+
+	/** Whether a location is within a periphery cone. The cone's angle is the cosine of half of the cone's angle, so it's only calculated once */
+	FORCEINLINE bool IsWithinCone(const FVector& Origin, const FVector& Forward, const FVector& Location, const float Length, const float CosHalfAngle)
+	{
+		const FVector ToLocation = Location - Origin;
+		const float Distance = ToLocation.Size();
+		if (Distance > Length) return false;
+		if (Distance <= UE_KINDA_SMALL_NUMBER) return true;
+		return FVector::DotProduct(Forward, ToLocation / Distance) >= CosHalfAngle;
+	}
+
+	/**
+	 * Whether a sphere overlaps a cone with a flat base, like the periphery cone's mesh. The length is along the cone's direction from it's tip,
+	 * and the angle is the cosine and sine of half of the cone's angle
+	 */
+	FORCEINLINE bool IsSphereWithinCone(const FVector& Origin, const FVector& Forward, const FVector& Center, const float Radius, const float Length, const float CosHalfAngle, const float SinHalfAngle)
+	{
+		const FVector ToCenter = Center - Origin;
+		const double AlongAxis = FVector::DotProduct(ToCenter, Forward);
+		if (AlongAxis < -Radius || AlongAxis > Length + Radius) return false;
+
+		// The distance from the center to the side of the cone, which is negative inside of it
+		const double FromAxis = (ToCenter - Forward * AlongAxis).Size();
+		return FromAxis * CosHalfAngle - AlongAxis * SinHalfAngle <= Radius;
+	}
+
+	/** The inverse of a ray's direction for the box intersections. Axes the ray doesn't move along use a large number instead of dividing by zero */
+	FORCEINLINE FVector GetInverseDirection(const FVector& Direction)
+	{
+		return FVector(
+			FMath::IsNearlyZero(Direction.X) ? UE_BIG_NUMBER : 1.0 / Direction.X,
+			FMath::IsNearlyZero(Direction.Y) ? UE_BIG_NUMBER : 1.0 / Direction.Y,
+			FMath::IsNearlyZero(Direction.Z) ? UE_BIG_NUMBER : 1.0 / Direction.Z
+		);
+	}
+
+	/** Whether a ray hits a box before the max distance, and the distance along the ray where it enters the box (zero if it starts inside of it) */
+	FORCEINLINE bool IntersectRayBox(const FVector& Origin, const FVector& InverseDirection, const FVector& Min, const FVector& Max, const double MaxDistance, double& OutDistance)
+	{
+		const FVector T0 = (Min - Origin) * InverseDirection;
+		const FVector T1 = (Max - Origin) * InverseDirection;
+		const double Near = FMath::Max3(FMath::Min(T0.X, T1.X), FMath::Min(T0.Y, T1.Y), FMath::Min(T0.Z, T1.Z));
+		const double Far = FMath::Min3(FMath::Max(T0.X, T1.X), FMath::Max(T0.Y, T1.Y), FMath::Max(T0.Z, T1.Z));
+		if (Near > Far || Far < 0 || Near > MaxDistance) return false;
+
+		OutDistance = FMath::Max(Near, 0.0);
+		return true;
+	}
+
+
+	/** How long until something could cross a radius, from it's distance to the center and it's speed relative to the center. This is the max time if it isn't moving */
+	FORCEINLINE double TimeUntilRadiusCrossing(const double Distance, const double Radius, const double RelativeSpeed, const double MaxTime)
+	{
+		if (RelativeSpeed <= UE_KINDA_SMALL_NUMBER) return MaxTime;
+		return FMath::Min(FMath::Abs(Distance - Radius) / RelativeSpeed, MaxTime);
+	}
+
+	/** The squared distance between a segment and a box centered on the origin */
+	inline double SegmentDistToBoxSquared(const FVector& Start, const FVector& End, const FVector& Extent)
+	{
+		// The distance is a quadratic along each piece of the segment between the box's planes
+		const FVector Direction = End - Start;
+		double Times[8] = {0, 1};
+		int32 NumTimes = 2;
+		for (int32 Axis = 0; Axis < 3; Axis++)
+		{
+			if (FMath::Abs(Direction[Axis]) <= UE_SMALL_NUMBER) continue;
+			for (const double Plane : {-Extent[Axis], Extent[Axis]})
+			{
+				const double Time = (Plane - Start[Axis]) / Direction[Axis];
+				if (Time > 0 && Time < 1) Times[NumTimes++] = Time;
+			}
+		}
+		TArrayView<double>(Times, NumTimes).Sort();
+
+		double MinDistanceSquared = MAX_dbl;
+		for (int32 Piece = 0; Piece + 1 < NumTimes; Piece++)
+		{
+			// Each axis is either within the box or past one of it's planes for the whole piece
+			const double Middle = (Times[Piece] + Times[Piece + 1]) * 0.5;
+			double A = 0, B = 0, C = 0;
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				const double Position = Start[Axis] + Direction[Axis] * Middle;
+				if (FMath::Abs(Position) <= Extent[Axis]) continue;
+
+				const double Offset = Start[Axis] - (Position > 0 ? Extent[Axis] : -Extent[Axis]);
+				A += Direction[Axis] * Direction[Axis];
+				B += 2 * Offset * Direction[Axis];
+				C += Offset * Offset;
+			}
+
+			const double Time = A > UE_SMALL_NUMBER ? FMath::Clamp(-B / (2 * A), Times[Piece], Times[Piece + 1]) : Times[Piece];
+			MinDistanceSquared = FMath::Min(MinDistanceSquared, (A * Time + B) * Time + C);
+		}
+		return MinDistanceSquared;
+	}
+
+	/**
+	 * Whether the center of a radius passed within the radius of a box while moving in a straight line between two locations (relative to the box's center). \n\n
+	 * This uses the same distance to the box as the discrete radius checks, so objects aren't treated differently depending on whether they were swept
+	 */
+	FORCEINLINE bool SweptBoxWithinRadius(const FVector& Start, const FVector& End, const FVector& Extent, const float Radius)
+	{
+		return SegmentDistToBoxSquared(Start, End, Extent) <= FMath::Square(Radius);
+	}
+
+
+	/** Which of the trace periphery events should be activated when the traced object changes */
+	struct FTraceTransition
+	{
+		/** The previous object should receive the outside of trace events */
+		bool bExitPrevious = false;
+
+		/** The current object should receive the within trace events */
+		bool bEnterCurrent = false;
+	};
+
+	/**
+	 * Finds the trace transition between the previous and current traced objects. Nothing happens while the player is still aiming at the same thing,
+	 * and only valid periphery objects receive enter and exit events
+	 */
+	FORCEINLINE FTraceTransition ResolveTraceTransition(const bool bHasPrevious, const bool bPreviousValid, const bool bHasCurrent, const bool bCurrentValid, const bool bSameTarget)
+	{
+		FTraceTransition Transition;
+		if (bSameTarget) return Transition;
+
+		Transition.bExitPrevious = bHasPrevious && bPreviousValid;
+		Transition.bEnterCurrent = bHasCurrent && bCurrentValid;
+		return Transition;
+	}
+}
@@ -0,0 +1,87 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryTypes.h"
+#include <atomic>
+
+
+/** A periphery event, for systems that process the events away from the game thread (analytics, audio, ai memory) */
+struct FPeripheryEventRecord
+{
+	/** The unique ids of the owner of the periphery and the object (these are only valid for the current session) */
+	uint32 OwnerId = 0;
+	uint32 ObjectId = 0;
+
+	/** The object's handle in the periphery object registry, this isn't set if the object isn't registered */
+	FPeripheryHandle Handle;
+
+	/** The world's time when the event happened */
+	double Timestamp = 0;
+
+	/** The radius ring of the event, if it's a radius ring event */
+	int32 RingIndex = INDEX_NONE;
+
+	/** The item id of the item instance, if it's an item instance event (the object is the actor that owns the instances) */
+	int32 ItemId = INDEX_NONE;
+
+	EPeripheryKind Kind = EPeripheryKind::EPK_Radius;
+	bool bEnter = false;
+};
+
+
+/**
+ * A bounded lock free queue of periphery events, which can be published from any thread and drained by one consumer (for example a task that's processing the events). \n\n
+ * Events are dropped if the channel is full instead of waiting on the consumer, so the consumer should drain it often enough or use a larger capacity.
+ * The number of dropped events and the most events the channel has held at once are tracked for finding the right capacity
+ */
+class PERIPHERYSYSTEMCOMPONENT_API FPeripheryEventChannel
+{
+public:
+	/** The capacity is rounded up to a power of two */
+	explicit FPeripheryEventChannel(uint32 Capacity);
+
+	/** Adds an event to the channel, and returns false if the channel is full. This is safe to call from any thread, but UPeripheryWorldSubsystem only publishes on the game thread */
+	bool Publish(const FPeripheryEventRecord& Record);
+
+	/** Removes the oldest event from the channel, and returns false if it's empty. Only one thread should consume the events at a time */
+	bool Consume(FPeripheryEventRecord& OutRecord);
+
+	/** Consumes events until the channel is empty (or the max number of events have been consumed), and returns how many were consumed */
+	template<typename FunctionType>
+	int32 Drain(FunctionType&& Function, const int32 MaxRecords = MAX_int32)
+	{
+		FPeripheryEventRecord Record;
+		int32 NumRecords = 0;
+		while (NumRecords < MaxRecords && Consume(Record))
+		{
+			Function(Record);
+			NumRecords++;
+		}
+		return NumRecords;
+	}
+
+	uint32 GetCapacity() const { return Mask + 1; }
+	uint64 GetNumDropped() const { return NumDropped.load(std::memory_order_relaxed); }
+	uint32 GetHighWaterMark() const { return HighWaterMark.load(std::memory_order_relaxed); }
+
+
+protected:
+	/** Each slot's sequence is how the publishers and the consumer know whether it's been written to or read from */
+	struct FSlot
+	{
+		std::atomic<uint64> Sequence;
+		FPeripheryEventRecord Record;
+	};
+
+	TUniquePtr<FSlot[]> Slots;
+	uint32 Mask;
+
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> EnqueuePosition{0};
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> DequeuePosition{0};
+	alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint64> NumDropped{0};
+	std::atomic<uint32> HighWaterMark{0};
+
+
+};
@@ -0,0 +1,74 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+#include "PeripheryTypes.h"
+#include "UObject/ObjectKey.h"
+#include "PeripheryFilter.generated.h"
+
+
+/**
+ * Which objects are valid for one of the peripheries. Everything here is checked natively, and the periphery's validator (IsValidObjectInRadius() etc) is only used afterwards if it's needed
+ */
+USTRUCT(BlueprintType)
+struct PERIPHERYSYSTEMCOMPONENT_API FPeripheryFilter
+{
+	GENERATED_BODY()
+
+	/** The classes that are valid (including their subclasses). If this is empty every class is valid */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Filter") TArray<TSubclassOf<AActor>> ValidClasses;
+
+	/** Whether the object needs to implement the periphery interface */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Filter") bool bRequirePeripheryInterface = false;
+
+	/** The periphery types that are valid. This is the type the object was registered with in the periphery object registry (objects that aren't registered are None) */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Filter", meta = (Bitmask, BitmaskEnum = "/Script/PeripherySystemComponent.EPeripheryType")) int32 ValidPeripheryTypes = 0xFF;
+
+	/** The tags the object needs to have. The tags are found with the IGameplayTagAssetInterface, objects that don't implement it don't have any tags */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Filter") FGameplayTagContainer RequiredTags;
+
+	/** The object isn't valid if it has any of these tags */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Filter") FGameplayTagContainer BlockedTags;
+
+	/** A query the object's tags need to match, for anything the required and blocked tags can't handle */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Filter") FGameplayTagQuery TagQuery;
+};
+
+
+/**
+ * The periphery filters, compiled for checking objects without any blueprint logic. \n\n
+ * The class and interface checks only depend on the object's class, so they're cached for each class the first time it's checked and every object after that is a single lookup
+ */
+class PERIPHERYSYSTEMCOMPONENT_API FPeripheryCompiledFilters
+{
+public:
+	/** The most filters that can be compiled together, since each class caches one bit for each filter */
+	static constexpr int32 MaxFilters = 32;
+
+	/** Compiles the filters, which clears the cached classes. The filters need to stay valid until they're compiled again */
+	void Compile(TConstArrayView<const FPeripheryFilter*> InFilters);
+	bool IsCompiled() const { return bCompiled; }
+
+	/** Whether an object passes one of the filters. This doesn't use the periphery's validator */
+	bool Passes(int32 FilterIndex, const AActor* Actor, EPeripheryType PeripheryType) const;
+
+	/** Whether one of the filters checks the periphery type, so the type only needs to be found when it's used */
+	bool UsesPeripheryTypes(const int32 FilterIndex) const { return (TypeFilterMask & (1u << FilterIndex)) != 0; }
+
+
+protected:
+	/** The filters each class passes the class checks for (one bit for each filter) */
+	uint32 GetClassMask(const UClass* Class) const;
+
+	TArray<const FPeripheryFilter*> Filters;
+	mutable TMap<FObjectKey, uint32> ClassMasks;
+
+	/** The filters that check the periphery types, and the filters that check tags */
+	uint32 TypeFilterMask = 0;
+	uint32 TagFilterMask = 0;
+	bool bCompiled = false;
+
+
+};
@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PeripheryHighlightSubsystem.generated.h"
+
+
+/** The number of highlight changes since the stats were reset, for finding how much work the highlights are actually doing */
+USTRUCT(BlueprintType)
+struct FPeripheryHighlightStats
+{
+	GENERATED_BODY()
+
+	/** Every highlight that was requested or removed */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Highlight") int32 NumRequests = 0;
+
+	/** Objects that were highlighted or unhighlighted (or had their stencil value changed) */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Highlight") int32 NumStateChanges = 0;
+
+	/** Objects that were changed during the frame but ended up the same as they were, so nothing was applied */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Highlight") int32 NumSkippedChanges = 0;
+
+	/** The components that had their render state changed */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Highlight") int32 NumComponentUpdates = 0;
+};
+
+
+/**
+ * Handles highlighting the objects the periphery components find, using each mesh's custom depth and stencil value. \n\n
+ * Every observer (periphery component) requests highlights for each of it's peripheries, and an object stays highlighted until every request for it has been removed.
+ * The requests are only applied once per frame, after the actors have ticked, so an object that enters and leaves a periphery during the same frame is never changed,
+ * and crowds that enter a periphery at once update their render state in one batch instead of during each overlap. \n\n
+ * The stats (Periphery.Highlight.Stats) track how many changes were actually applied
+ */
+UCLASS()
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryHighlightSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** An object's highlight requests, and the highlight that's currently applied to it */
+	struct FHighlightState
+	{
+		TWeakObjectPtr<AActor> Target;
+
+		/** The stencil value of each request, keyed by the observer and it's source */
+		TMap<TPair<FObjectKey, int32>, int32> Requests;
+
+		bool bApplied = false;
+		int32 AppliedStencilValue = 0;
+	};
+
+	/** The highlight state of each object that's highlighted or has pending changes */
+	TMap<FObjectKey, FHighlightState> Highlights;
+
+	/** The objects that have changed since the highlights were last applied */
+	TSet<FObjectKey> DirtyTargets;
+
+	FPeripheryHighlightStats Stats;
+
+
+public:
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Requests or removes a highlight for an object. The change is applied at the end of the frame.
+	 * @param Observer The object requesting the highlight, usually a periphery component
+	 * @param Source Which of the observer's peripheries is requesting the highlight, each observer can have one request for each source
+	 * @param StencilValue The custom depth stencil value, if there are multiple requests the highest value is used
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") void SetHighlight(AActor* Target, const UObject* Observer, int32 Source, bool bHighlight, int32 StencilValue = 1);
+
+	/** Removes every highlight an observer requested, for when it's destroyed */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") void ClearObserver(const UObject* Observer);
+
+	/** Applies the pending highlight changes. This happens automatically at the end of every frame */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") void ApplyHighlights();
+
+	/** Whether an object is currently highlighted (pending changes aren't included until they've been applied) */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") bool IsHighlighted(const AActor* Target) const;
+
+	/** The number of requests for an object's highlight */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") int32 GetNumHighlightRequests(const AActor* Target) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") FPeripheryHighlightStats GetStats() const { return Stats; }
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Highlight") void ResetStats() { Stats = FPeripheryHighlightStats(); }
+
+
+protected:
+	/**
+	 * Applies the highlight to each of the object's meshes, and returns the number of components that were changed. Override this for other kinds of highlights (like overlay materials)
+	 * @remark Components that are already in the right state aren't changed, so their render state isn't marked dirty
+	 */
+	virtual int32 ApplyHighlight(AActor* Target, bool bHighlight, int32 StencilValue);
+
+
+};
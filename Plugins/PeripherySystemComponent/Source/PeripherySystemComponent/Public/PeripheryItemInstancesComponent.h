@@ -0,0 +1,62 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryTypes.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
+#include "PeripheryItemInstancesComponent.generated.h"
+
+class UPeripheryItemInstancesComponent;
+
+/** An item's instance was removed. The component's last instance is moved into the removed instance's index, MovedFromIndex is INDEX_NONE if the removed instance was the last one */
+DECLARE_MULTICAST_DELEGATE_FourParams(FOnPeripheryItemInstanceRemoved, UPeripheryItemInstancesComponent* /*Component*/, int32 /*ItemId*/, int32 /*RemovedIndex*/, int32 /*MovedFromIndex*/);
+
+
+/**
+ * An instanced static mesh for periphery items that don't need their own actor (like the pickups of a loot heavy map), where every instance has an item id. \n\n
+ * Item detection finds the instances through their overlaps, and the trace through the instance it hit, and both of them send the item instance events instead of treating the
+ * component's actor as the item. The item ids are stored in the instances' custom data so they stay with the instances when the component reorders them.
+ * Instances that are added without an item id (with AddInstance()) aren't items, and every item id can only be used by one instance
+ *
+ * @remark The instances need collision that overlaps the item detection channel, and the object type needs to be one of the trace's object types
+ */
+UCLASS(ClassGroup = (Peripheries), meta = (BlueprintSpawnableComponent))
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryItemInstancesComponent : public UHierarchicalInstancedStaticMeshComponent
+{
+	GENERATED_BODY()
+
+protected:
+	/** The custom data float the item id is stored in. Item ids are stored as floats, so they need to be smaller than 16777216 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Peripheries|Item Instances", meta = (ClampMin = "0")) int32 ItemIdCustomDataIndex;
+
+
+public:
+	UPeripheryItemInstancesComponent(const FObjectInitializer& ObjectInitializer);
+	virtual void OnRegister() override;
+	virtual void PostLoad() override;
+	virtual int32 AddInstance(const FTransform& InstanceTransform, bool bWorldSpace = false) override;
+	virtual TArray<int32> AddInstances(const TArray<FTransform>& InstanceTransforms, bool bShouldReturnIndices, bool bWorldSpace = false) override;
+
+	/** Called once an item's instance has been removed, so the periphery components can remove it and update the index of the instance that was moved into it's place */
+	FOnPeripheryItemInstanceRemoved OnItemInstanceRemoved;
+
+	/** Adds an instance for an item and returns it's instance index, or INDEX_NONE if the item id isn't valid or another instance already has it */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Item Instances") int32 AddItemInstance(const FTransform& InstanceTransform, int32 ItemId, bool bWorldSpace = false);
+
+	/** Removes the instance of an item, and returns whether it was found. The last instance is moved into the removed instance's index */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Item Instances") bool RemoveItemInstance(int32 ItemId);
+
+	/** Returns the item id of an instance, or INDEX_NONE if the instance isn't valid */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Item Instances") int32 GetItemId(int32 InstanceIndex) const;
+
+	/** Returns the instance index of an item, or INDEX_NONE if it isn't found */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Item Instances") int32 FindItemInstance(int32 ItemId) const;
+
+
+protected:
+	/** Adds the item id's custom data float if the component doesn't have it. This clears the custom data of every instance, so it's done before the items are added */
+	void InitItemIdCustomData();
+
+
+};
@@ -0,0 +1,106 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PeripheryLagCompensation.generated.h"
+
+
+/** What a client's periphery trace found, sent to the server so it can validate interactions without tracing again */
+USTRUCT(BlueprintType)
+struct FPeripheryTraceClaim
+{
+	GENERATED_BODY()
+
+	/** The owner of the periphery component that performed the trace. The server replaces this with the actor that received the claim, since clients could claim to be anyone */
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Lag Compensation") TObjectPtr<AActor> Owner;
+
+	/** The object the client's trace found */
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Lag Compensation") TObjectPtr<AActor> Target;
+
+	/** The start of the client's trace, and it's normalized direction */
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Lag Compensation") FVector Origin = FVector::ZeroVector;
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Lag Compensation") FVector Direction = FVector::ForwardVector;
+
+	/** The client's estimate of the server's world time when it performed the trace */
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Lag Compensation") double Timestamp = 0;
+};
+
+DECLARE_DYNAMIC_DELEGATE_TwoParams(FOnPeripheryTraceClaimValidated, const FPeripheryTraceClaim&, Claim, bool, bValid);
+
+
+/**
+ * Validates the periphery traces of clients on the server, for when the periphery logic runs on the client (EP_Client) and the client tells the server what it's interacting with. \n\n
+ * The server keeps a short history of the bounds of every registered periphery object, and checks each claim's aim ray against the bounds of it's target from when the client traced it,
+ * instead of tracing the world again for every request. Claims are queued and validated together once per frame, after the actors have ticked.
+ * The history is only recorded on servers, once the first claim has been submitted.
+ *
+ * @remark Only objects in the periphery object registry can be validated. The claims are checked against the object's bounds, and only trace the world if Periphery.LagCompensation.OcclusionTrace is set
+ */
+UCLASS()
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryLagCompensation : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The bounds of every registered object at a point in time, indexed by the slot of their handle */
+	struct FBoundsSnapshot
+	{
+		double Time = 0;
+
+		/** The generation of the handle in each slot, zero if there wasn't an object in the slot */
+		TArray<uint32> Generations;
+		TArray<FVector3f> BoundsMin;
+		TArray<FVector3f> BoundsMax;
+	};
+
+	/** The bounds history, a ring buffer that overwrites the oldest snapshot once it's full */
+	TArray<FBoundsSnapshot> Snapshots;
+	int32 NewestSnapshot = INDEX_NONE;
+	int32 NumSnapshots = 0;
+
+	/** The claims waiting to be validated this frame */
+	TArray<TPair<FPeripheryTraceClaim, FOnPeripheryTraceClaimValidated>> PendingClaims;
+
+	/** Whether a claim has been submitted, the history isn't recorded until something needs it */
+	bool bRecordingHistory = false;
+
+	int32 NumValidClaims = 0;
+	int32 NumRejectedClaims = 0;
+
+
+public:
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/**
+	 * Queues a client's trace claim, the delegate is called once it's been validated (at the end of the frame). This should only be called on the server, anywhere else the claim is rejected immediately
+	 * @param Sender The actor that received the client's rpc, which is owned by the client's connection. The claim's owner is replaced with it (or it's pawn, if it's a player controller)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Lag Compensation") void SubmitTraceClaim(AActor* Sender, const FPeripheryTraceClaim& Claim, FOnPeripheryTraceClaimValidated OnValidated);
+
+	/** Validates a trace claim immediately. The queued claims use this once per frame. The claim's owner is trusted, so set it on the server before calling this */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Lag Compensation") bool ValidateTraceClaim(const FPeripheryTraceClaim& Claim) const;
+
+	/** Finds the bounds of a registered object at a point in the history, interpolated between the snapshots around it */
+	bool GetRewoundBounds(const FPeripheryHandle& Handle, double Time, FVector3f& OutMin, FVector3f& OutMax) const;
+
+	/** The number of claims that have been validated and rejected */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Lag Compensation") int32 GetNumValidClaims() const { return NumValidClaims; }
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Lag Compensation") int32 GetNumRejectedClaims() const { return NumRejectedClaims; }
+
+
+protected:
+	/** Adds the bounds of every registered object to the history */
+	virtual void RecordSnapshot(double Time);
+
+	/** Validates every pending claim and activates their delegates */
+	virtual void ValidatePendingClaims();
+
+	/** Returns the snapshot at a position in the history, where zero is the oldest snapshot */
+	const FBoundsSnapshot& GetSnapshot(int32 HistoryIndex) const;
+
+
+};
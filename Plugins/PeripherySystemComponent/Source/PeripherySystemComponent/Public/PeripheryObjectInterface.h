@@ -24,6 +24,11 @@ class PERIPHERYSYSTEMCOMPONENT_API IPeripheryObjectInterface
 
 	
 public:
+	/** The periphery type of this object. This is stored in the periphery object registry when the object is registered */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries", DisplayName = "(Periphery Interface) Get Periphery Type") 
+	EPeripheryType GetPeripheryType() const;
+	virtual EPeripheryType GetPeripheryType_Implementation() const;
+	
 	/** Logic when a character registers it within it's periphery */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Radius", DisplayName = "(Periphery Interface) Within Player Radius Periphery") 
 	void WithinPlayerRadiusPeriphery(AActor* SourceCharacter, EPeripheryType PeripheryType);
@@ -34,6 +39,16 @@ public:
 	void OutsideOfPlayerRadiusPeriphery(AActor* SourceCharacter, EPeripheryType PeripheryType);
 	virtual void OutsideOfPlayerRadiusPeriphery_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType);
 	
+	/** Logic when a character registers it within one of it's radius rings */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Radius Rings", DisplayName = "(Periphery Interface) Within Player Radius Ring") 
+	void WithinPlayerRadiusRing(AActor* SourceCharacter, EPeripheryType PeripheryType, int32 RingIndex, FName RingName);
+	virtual void WithinPlayerRadiusRing_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType, int32 RingIndex, FName RingName);
+
+	/** Logic when a character unregisters it from one of it's radius rings */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Radius Rings", DisplayName = "(Periphery Interface) Outside Of Player Radius Ring") 
+	void OutsideOfPlayerRadiusRing(AActor* SourceCharacter, EPeripheryType PeripheryType, int32 RingIndex, FName RingName);
+	virtual void OutsideOfPlayerRadiusRing_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType, int32 RingIndex, FName RingName);
+	
 	/** Logic when a character's periphery cone registers the object */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Cone", DisplayName = "(Periphery Interface) Within Player Cone Periphery") 
 	void WithinPlayerConePeriphery(AActor* SourceCharacter, EPeripheryType PeripheryType);
@@ -54,5 +69,15 @@ public:
 	void OutsideOfPlayerTracePeriphery(AActor* SourceCharacter, EPeripheryType PeripheryType);
 	virtual void OutsideOfPlayerTracePeriphery_Implementation(AActor* SourceCharacter, EPeripheryType PeripheryType);
 
+	/** Logic when a character's item detection or trace registers one of this object's item instances */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Item Instances", DisplayName = "(Periphery Interface) Within Player Item Instance") 
+	void WithinPlayerItemInstance(AActor* SourceCharacter, const FPeripheryItemInstance& Instance, EPeripheryKind PeripheryKind);
+	virtual void WithinPlayerItemInstance_Implementation(AActor* SourceCharacter, const FPeripheryItemInstance& Instance, EPeripheryKind PeripheryKind);
+
+	/** Logic when a character's item detection or trace unregisters one of this object's item instances */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Item Instances", DisplayName = "(Periphery Interface) Outside Of Player Item Instance") 
+	void OutsideOfPlayerItemInstance(AActor* SourceCharacter, const FPeripheryItemInstance& Instance, EPeripheryKind PeripheryKind);
+	virtual void OutsideOfPlayerItemInstance_Implementation(AActor* SourceCharacter, const FPeripheryItemInstance& Instance, EPeripheryKind PeripheryKind);
+
 	
 };
@@ -0,0 +1,168 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PeripheryObjectRegistry.generated.h"
+
+class USceneComponent;
+class APeripheryStaticIndex;
+
+
+/** The information of a periphery object that doesn't change once it's registered */
+struct FPeripheryObjectInfo
+{
+	EPeripheryType Type = EPeripheryType::EPT_None;
+	uint8 Team = 255;
+	EPeripheryObjectFlags Flags = EPeripheryObjectFlags::EPO_None;
+
+	/** The offset of the bounds from the object's location (in local space), and the radius of the bounds */
+	FVector3f LocalBoundsOffset = FVector3f::ZeroVector;
+	float BoundsRadius = 0;
+};
+
+
+/**
+ * A world level record of every periphery object (actors implementing the IPeripheryObjectInterface). \n\n
+ * Periphery objects are registered once they've begun play (the registry checks the objects that were spawned or streamed in at the end of each frame), and receive a stable handle that's invalidated once they're removed.
+ * Static objects that were baked into a level's APeripheryStaticIndex are added from the index instead, and levels with an index don't need to be searched for their objects.
+ * Their positions, bounds, periphery types, teams and flags are stored in packed arrays that are updated when they move, so the periphery logic can iterate over
+ * everything without touching the actors
+ *
+ * @remark The packed arrays are reordered when objects are removed, use the handles to keep track of specific objects
+ */
+UCLASS()
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryObjectRegistry : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/**** Handle slots ****/
+	/** The generation of each handle slot, this is incremented once an object is removed */
+	TArray<uint32> SlotGenerations;
+
+	/** The packed index of the object for each handle slot (INDEX_NONE if the slot is free) */
+	TArray<int32> SlotToPacked;
+
+	/** The handle slots that are free to be reused */
+	TArray<uint32> FreeSlots;
+
+
+	/**** Packed object information ****/
+	TArray<FPeripheryHandle> Handles;
+	TArray<FVector> Positions;
+	TArray<FVector3f> BoundsMin;
+	TArray<FVector3f> BoundsMax;
+	TArray<EPeripheryType> Types;
+	TArray<uint8> Teams;
+	TArray<EPeripheryObjectFlags> Flags;
+
+	/** The offset of the bounds from the object's location (in local space), and the radius of the bounds */
+	TArray<FVector3f> LocalBoundsOffsets;
+	TArray<float> BoundsRadii;
+	TArray<TWeakObjectPtr<AActor>> Actors;
+	TArray<FDelegateHandle> TransformDelegates;
+
+	/** The handle of each registered actor */
+	TMap<FObjectKey, FPeripheryHandle> ActorHandles;
+
+	/** The static index of each level that has one */
+	TMap<FObjectKey, TWeakObjectPtr<const APeripheryStaticIndex>> LevelIndexes;
+
+	/** The periphery objects that were spawned or streamed in, which are registered once they've begun play (and have their components and teams) */
+	TArray<TWeakObjectPtr<AActor>> PendingActors;
+
+	FDelegateHandle ActorSpawnedDelegate;
+	FDelegateHandle ActorDestroyedDelegate;
+	FDelegateHandle LevelAddedDelegate;
+	FDelegateHandle LevelRemovedDelegate;
+
+
+public:
+	virtual bool DoesSupportWorldType(const EWorldType::Type WorldType) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void OnWorldBeginPlay(UWorld& InWorld) override;
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	/** Adds an object to the registry and returns it's handle. Periphery objects are registered automatically, this is for adding objects that don't implement the periphery interface */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Registry") FPeripheryHandle RegisterPeripheryObject(AActor* Actor);
+
+	/** Calculates the information of a registered object again, for objects whose periphery type or team has changed. Moving objects update their teams automatically */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Registry") void UpdatePeripheryObject(AActor* Actor);
+
+	/**
+	 * Adds the static objects of a level's static index, without having to calculate their information. Objects that are already registered are skipped. \n\n
+	 * Static objects don't track their transforms or bind their EndPlay, they're removed once they're destroyed or their level is removed
+	 */
+	void AddStaticIndex(const APeripheryStaticIndex& StaticIndex);
+
+	/** Calculates the information of an object for the registry */
+	static FPeripheryObjectInfo CalculateObjectInfo(const AActor* Actor);
+
+	/** Calculates the bounds of an object from it's actor's transform */
+	static void CalculateBounds(const AActor* Actor, const FVector3f& LocalBoundsOffset, float BoundsRadius, FVector3f& OutMin, FVector3f& OutMax);
+
+	/** Removes an object from the registry, which invalidates it's handle */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Registry") void UnregisterPeripheryObject(AActor* Actor);
+
+	/** Returns the handle of a registered object (or an unset handle if it isn't registered) */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Registry") FPeripheryHandle FindHandle(const AActor* Actor) const;
+
+	/** Returns the object of a handle, or nullptr if it's no longer registered */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Registry") AActor* GetActor(const FPeripheryHandle& Handle) const;
+
+	/** Whether a handle's object is still registered */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Registry") bool IsValidHandle(const FPeripheryHandle& Handle) const;
+
+	/** Returns the packed index of a handle, or INDEX_NONE if it's invalid */
+	int32 GetPackedIndex(const FPeripheryHandle& Handle) const;
+
+	/** Adds the handles of every object whose location is within the sphere */
+	void QuerySphere(const FVector& Center, float Radius, TArray<FPeripheryHandle>& OutHandles) const;
+
+	/**
+	 * Checks a ray against the bounds of every object, and returns whether it passes through any of them. \n\n
+	 * The distances are where the ray enters the closest bounds, and where it leaves the farthest bounds (within the max distance), so anything past that can't be one of the objects
+	 * @param IgnoredHandles The objects the ray skips, like the owner of the ray and anything else it's trace ignores
+	 */
+	bool RaycastBounds(const FVector& Origin, const FVector& Direction, float MaxDistance, TConstArrayView<FPeripheryHandle> IgnoredHandles, float& OutNearDistance, float& OutFarDistance) const;
+
+	/** The packed object information. These are indexed with GetPackedIndex() */
+	int32 Num() const { return Handles.Num(); }
+	TConstArrayView<FPeripheryHandle> GetHandles() const { return Handles; }
+	TConstArrayView<FVector> GetPositions() const { return Positions; }
+	TConstArrayView<FVector3f> GetBoundsMin() const { return BoundsMin; }
+	TConstArrayView<FVector3f> GetBoundsMax() const { return BoundsMax; }
+	TConstArrayView<EPeripheryType> GetTypes() const { return Types; }
+	TConstArrayView<uint8> GetTeams() const { return Teams; }
+	TConstArrayView<EPeripheryObjectFlags> GetFlags() const { return Flags; }
+
+
+protected:
+	void OnActorSpawned(AActor* Actor);
+	void OnActorDestroyed(AActor* Actor);
+	void OnLevelAddedToWorld(ULevel* Level, UWorld* World);
+	void OnLevelRemovedFromWorld(ULevel* Level, UWorld* World);
+
+	/** Finds the periphery objects of a level. Levels with a static index use it's list of objects, everything else is searched */
+	void RegisterLevelObjects(ULevel& Level);
+
+	UFUNCTION() void OnActorEndPlay(AActor* Actor, EEndPlayReason::Type EndPlayReason);
+	void OnTransformUpdated(USceneComponent* UpdatedComponent, EUpdateTransformFlags UpdateTransformFlags, ETeleportType Teleport);
+
+	/** Adds an object to the packed arrays and returns it's packed index. The bounds need to be set afterwards. Static objects don't track their transform or EndPlay */
+	int32 AddObject(AActor* Actor, const FVector& Position, const FPeripheryObjectInfo& Info, bool bStatic);
+
+	/** Registers the pending actors that have begun play */
+	void RegisterPendingActors();
+
+	/** Updates the position, bounds and team of an object from it's actor */
+	void UpdateTransform(int32 PackedIndex, const AActor* Actor);
+
+
+};
@@ -0,0 +1,235 @@
+#pragma once
+
+
+#include "CoreMinimal.h"
+#include "PeripheryTypes.h"
+#include "UObject/ObjectKey.h"
+
+class IMappedFileHandle;
+class IMappedFileRegion;
+
+
+/**
+ * The binary layout of a periphery recording. \n\n
+ * A recording is a header followed by records, and every record starts with it's record type. Names are written the first time an actor is recorded,
+ * and every frame contains the candidate actors that were recorded that frame, followed by each owner and the candidates that were within it's periphery. \n\n
+ * Everything is 4 byte aligned so the recording can be read directly from a memory mapped file
+ */
+namespace PeripheryRecording
+{
+	static constexpr uint32 Magic = 0x43455250; // PREC
+	static constexpr uint32 Version = 2;
+
+	enum class ERecordType : uint32
+	{
+		Name = 1,
+		Frame = 2
+	};
+
+	/** The owner's flags */
+	enum EOwnerFlags : uint32
+	{
+		OF_Radius				= 1 << 0,
+		OF_Cone					= 1 << 1,
+		OF_Trace				= 1 << 2,
+		OF_TracedValid			= 1 << 3
+	};
+
+	/** The flags of a candidate for a specific owner */
+	enum ECandidateFlags : uint32
+	{
+		CF_ValidRadiusObject	= 1 << 0,
+		CF_ValidConeObject		= 1 << 1
+	};
+}
+
+
+/** The beginning of every recording */
+struct FPeripheryRecordingHeader
+{
+	uint32 Magic = PeripheryRecording::Magic;
+	uint32 Version = PeripheryRecording::Version;
+};
+
+/** A recorded frame. This is followed by the candidates, and then the owners */
+struct FPeripheryRecordedFrame
+{
+	uint32 FrameNumber = 0;
+	float Time = 0;
+	uint32 NumCandidates = 0;
+	uint32 NumOwners = 0;
+};
+
+/** An actor that could be within an owner's periphery, and the bounds of it's colliding components (what the periphery overlaps are tested against) */
+struct FPeripheryRecordedCandidate
+{
+	uint32 ActorId = 0;
+	FVector3f BoundsOrigin = FVector3f::ZeroVector;
+	FVector3f BoundsExtent = FVector3f::ZeroVector;
+};
+
+/** An owner of a periphery component and it's periphery information for the frame. This is followed by it's entries */
+struct FPeripheryRecordedOwner
+{
+	uint32 OwnerId = 0;
+	FVector3f Location = FVector3f::ZeroVector;
+	FQuat4f Rotation = FQuat4f::Identity;
+	FVector3f AimOrigin = FVector3f::ZeroVector;
+	FVector3f AimDirection = FVector3f::ForwardVector;
+	FVector3f ConeOrigin = FVector3f::ZeroVector;
+	FVector3f ConeDirection = FVector3f::ForwardVector;
+	float Radius = 0;
+
+	/** The cone from the cone mesh's bounds, the length is along the cone's direction from it's tip */
+	float ConeLength = 0;
+	float ConeCosHalfAngle = 1;
+	uint32 TracedActorId = 0;
+	uint32 Flags = 0;
+	uint32 NumEntries = 0;
+};
+
+/** A candidate that's relevant to an owner, and whether it's a valid object for the owner's peripheries */
+struct FPeripheryRecordedEntry
+{
+	uint32 CandidateIndex = 0;
+	uint32 Flags = 0;
+};
+
+
+/**
+ * Writes the periphery information of every periphery component into a recording. \n\n
+ * Owners are added throughout the frame, and the frame is written once the next frame begins (or the recording is stopped)
+ */
+class PERIPHERYSYSTEMCOMPONENT_API FPeripheryRecorder
+{
+protected:
+	TUniquePtr<FArchive> Writer;
+	TMap<FObjectKey, uint32> ActorIds;
+
+	/** The candidates of each owner from the last time it was recorded, so the replay knows when they left */
+	TMap<uint32, TArray<TWeakObjectPtr<const AActor>>> PreviousCandidates;
+
+	uint64 PendingFrameNumber = 0;
+	float PendingTime = 0;
+	TArray<FPeripheryRecordedCandidate> PendingCandidates;
+	TMap<uint32, uint32> PendingCandidateIndices;
+	TArray<FPeripheryRecordedOwner> PendingOwners;
+	TArray<FPeripheryRecordedEntry> PendingEntries;
+
+
+public:
+	~FPeripheryRecorder();
+
+	/** Starts recording to a file. Returns false if the file couldn't be created */
+	bool Start(const FString& Filename);
+
+	/** Writes the pending frame and closes the recording */
+	void Stop();
+
+	bool IsRecording() const { return Writer.IsValid(); }
+
+	/** Returns the id of an actor within the recording, and records it's name the first time it's used */
+	uint32 GetActorId(const AActor* Actor);
+
+	/**
+	 * Adds an owner to the current frame
+	 * @param OwnerActor				The owner of the periphery component
+	 * @param Owner						The owner's periphery information, the id and number of entries are handled here
+	 * @param Candidates				The actors that are currently within the owner's peripheries
+	 * @param GetCandidateFlags			Returns the PeripheryRecording::ECandidateFlags of an actor for this owner
+	 */
+	void RecordOwner(const AActor* OwnerActor, FPeripheryRecordedOwner Owner, const TArray<AActor*>& Candidates, TFunctionRef<uint32(AActor*)> GetCandidateFlags);
+
+
+protected:
+	void FlushFrame();
+	uint32 AddCandidate(const AActor* Actor);
+};
+
+
+/**
+ * Reads a periphery recording from a memory mapped file (or from memory if the platform can't map files)
+ */
+class PERIPHERYSYSTEMCOMPONENT_API FPeripheryRecordingReader
+{
+protected:
+	TUniquePtr<IMappedFileHandle> MappedFile;
+	TUniquePtr<IMappedFileRegion> MappedRegion;
+	TArray<uint8> LoadedFile;
+
+	const uint8* Data = nullptr;
+	int64 Size = 0;
+	int64 Offset = 0;
+
+	TMap<uint32, FString> Names;
+
+
+public:
+	~FPeripheryRecordingReader();
+
+	/** Opens a recording. Returns false if the file couldn't be read or isn't a periphery recording */
+	bool Open(const FString& Filename);
+
+	/** Reads the next frame into the arrays (these are reused between frames). Returns false once the recording is finished */
+	bool ReadFrame(FPeripheryRecordedFrame& OutFrame, TArray<FPeripheryRecordedCandidate>& OutCandidates, TArray<FPeripheryRecordedOwner>& OutOwners, TArray<FPeripheryRecordedEntry>& OutEntries);
+
+	/** The name of an actor that was recorded */
+	FString GetName(uint32 ActorId) const;
+
+
+protected:
+	template<typename T> bool Read(T& Value);
+	template<typename T> bool ReadArray(TArray<T>& Values, uint32 Num);
+};
+
+
+/** A periphery event created during a replay */
+struct FPeripheryReplayEvent
+{
+	uint32 FrameNumber = 0;
+	float Time = 0;
+	uint32 OwnerId = 0;
+	uint32 ActorId = 0;
+	EPeripheryKind Kind = EPeripheryKind::EPK_Radius;
+	bool bEnter = false;
+};
+
+/** The results of a replay */
+struct FPeripheryReplayStats
+{
+	int32 NumFrames = 0;
+	int32 NumOwnerUpdates = 0;
+	int32 NumCandidateTests = 0;
+
+	/** The time spent on the periphery logic, without reading the recording */
+	double DetectionSeconds = 0;
+};
+
+
+/**
+ * Feeds a recording through the periphery detection logic without a game world, which is useful for comparing the performance and results of different detection logic. \n\n
+ * The trace events follow the same transitions as the periphery component. The radius and cone events are approximated from the candidates' recorded bounds
+ * and the recorded cone, instead of being reproduced from the physics overlaps, so they can differ from the component's events near the edges
+ */
+class PERIPHERYSYSTEMCOMPONENT_API FPeripheryReplay
+{
+protected:
+	struct FOwnerState
+	{
+		TSet<uint32> InRadius;
+		TSet<uint32> InCone;
+		uint32 TracedActorId = 0;
+		bool bTracedValid = false;
+	};
+	TMap<uint32, FOwnerState> OwnerStates;
+
+
+public:
+	/** Replays the recording and adds the events that were created */
+	bool Run(FPeripheryRecordingReader& Reader, TArray<FPeripheryReplayEvent>& OutEvents, FPeripheryReplayStats& OutStats);
+
+
+protected:
+	void UpdateOwner(const FPeripheryRecordedFrame& Frame, const FPeripheryRecordedOwner& Owner, TConstArrayView<FPeripheryRecordedEntry> Entries,
+		const TArray<FPeripheryRecordedCandidate>& Candidates, TArray<FPeripheryReplayEvent>& OutEvents, FPeripheryReplayStats& OutStats);
+};
@@ -0,0 +1,26 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "PeripheryReplayCommandlet.generated.h"
+
+
+/**
+ * Replays a periphery recording through the periphery detection logic without a game world, and outputs the events and how long the detection took. \n\n
+ * Usage: -run=PeripheryReplay -Recording=<File.prec> [-Output=<Events.csv>]
+ * 
+ * @remark Recordings are created with the Periphery.Record.Start and Periphery.Record.Stop console commands
+ */
+UCLASS()
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryReplayCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UPeripheryReplayCommandlet();
+	virtual int32 Main(const FString& Params) override;
+
+
+};
@@ -0,0 +1,80 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryTypes.h"
+#include "GameFramework/Info.h"
+#include "PeripheryStaticIndex.generated.h"
+
+
+/**
+ * The static periphery objects of a level (doors, terminals, containers), which are baked in the editor so the periphery object registry can add them at once when the level is loaded. \n\n
+ * Place one of these in a level (or in each world partition cell with it's spatial loading enabled) and build the index, it's also rebuilt whenever it's saved.
+ * Only objects with a static root component are baked. The level's other periphery objects are listed so the registry doesn't need to search the level for them,
+ * and they're registered once they've begun play
+ *
+ * @remark The index only contains the objects that are loaded when it's built, so with world partition load the cell's region before building it
+ * @remark With one file per actor, moving an indexed object doesn't resave the index. The map check warns about objects that have moved since the index was built
+ */
+UCLASS(NotBlueprintable, HideCategories = (Input, Movement, Collision, Rendering, HLOD, Replication, Physics, Networking, LevelInstance, Cooking))
+class PERIPHERYSYSTEMCOMPONENT_API APeripheryStaticIndex : public AInfo
+{
+	GENERATED_BODY()
+
+protected:
+	/** Whether to rebuild the index whenever it's saved */
+	UPROPERTY(EditAnywhere, Category = "Peripheries") bool bBuildOnSave = true;
+
+	/** The indexed objects, and their information for the periphery object registry. These are in the same level as the index, so they're loaded with it */
+	UPROPERTY(VisibleAnywhere, Category = "Peripheries") TArray<TObjectPtr<AActor>> Actors;
+	UPROPERTY() TArray<FVector> Positions;
+	UPROPERTY() TArray<FVector3f> BoundsMin;
+	UPROPERTY() TArray<FVector3f> BoundsMax;
+	UPROPERTY() TArray<EPeripheryType> Types;
+	UPROPERTY() TArray<uint8> Teams;
+	UPROPERTY() TArray<EPeripheryObjectFlags> Flags;
+	UPROPERTY() TArray<FVector3f> LocalBoundsOffsets;
+	UPROPERTY() TArray<float> BoundsRadii;
+
+	/** The level's periphery objects that aren't static, which are registered individually */
+	UPROPERTY(VisibleAnywhere, Category = "Peripheries") TArray<TObjectPtr<AActor>> DynamicActors;
+
+
+public:
+	APeripheryStaticIndex(const FObjectInitializer& ObjectInitializer);
+
+	/** Adds the index to the periphery object registry once it's registered, which is before the level's actors begin play */
+	virtual void PostRegisterAllComponents() override;
+
+#if WITH_EDITOR
+	/** Adds every static periphery object in the level to the index */
+	UFUNCTION(CallInEditor, Category = "Peripheries") void BuildIndex();
+	virtual void PreSave(FObjectPreSaveContext ObjectSaveContext) override;
+	virtual void CheckForErrors() override;
+
+	/** Whether an indexed object has moved since the index was built */
+	bool HasMoved(int32 IndexedObject) const;
+
+protected:
+	/** Replaces the index with the level's current static periphery objects */
+	void PopulateIndex();
+
+public:
+#endif
+
+	/** The indexed objects. Every array uses the same index */
+	int32 Num() const { return Actors.Num(); }
+	TConstArrayView<TObjectPtr<AActor>> GetActors() const { return Actors; }
+	TConstArrayView<TObjectPtr<AActor>> GetDynamicActors() const { return DynamicActors; }
+	TConstArrayView<FVector> GetPositions() const { return Positions; }
+	TConstArrayView<FVector3f> GetBoundsMin() const { return BoundsMin; }
+	TConstArrayView<FVector3f> GetBoundsMax() const { return BoundsMax; }
+	TConstArrayView<EPeripheryType> GetTypes() const { return Types; }
+	TConstArrayView<uint8> GetTeams() const { return Teams; }
+	TConstArrayView<EPeripheryObjectFlags> GetFlags() const { return Flags; }
+	TConstArrayView<FVector3f> GetLocalBoundsOffsets() const { return LocalBoundsOffsets; }
+	TConstArrayView<float> GetBoundsRadii() const { return BoundsRadii; }
+
+
+};
@@ -2,8 +2,12 @@
 
 
 #include "CoreMinimal.h"
+#include "Engine/EngineTypes.h"
+#include "Templates/SubclassOf.h"
 #include "PeripheryTypes.generated.h"
 
+class UPeripheryItemInstancesComponent;
+class UPrimitiveComponent;
 
 /**
  *	The periphery type based on the player and the periphery object (this helps with highlighting and other things)
@@ -30,3 +34,90 @@ enum class EHandlePeripheryLogic : uint8
 	EP_Server		    	UMETA(DisplayName = "Server"),
 	EP_Client    			UMETA(DisplayName = "Client"),
 };
+
+
+/**
+ *	Information about a registered periphery object, used by the periphery object registry
+ */
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EPeripheryObjectFlags : uint8
+{
+	EPO_None		 		= 0			UMETA(Hidden),
+	EPO_PeripheryInterface	= 1 << 0	UMETA(DisplayName = "Periphery Interface"),
+	EPO_TeamAgent			= 1 << 1	UMETA(DisplayName = "Team Agent")
+};
+ENUM_CLASS_FLAGS(EPeripheryObjectFlags);
+
+
+/**
+ *	The different peripheries of the periphery component, used when events are recorded or exported
+ */
+UENUM(BlueprintType)
+enum class EPeripheryKind : uint8
+{
+	EPK_Radius		 		UMETA(DisplayName = "Radius"),
+	EPK_Cone    			UMETA(DisplayName = "Cone"),
+	EPK_Trace		    	UMETA(DisplayName = "Trace"),
+	EPK_ItemDetection    	UMETA(DisplayName = "Item Detection"),
+	EPK_RadiusRing    		UMETA(DisplayName = "Radius Ring")
+};
+
+/**
+ *	The aim ray of a controller for the current frame, shared between every periphery component that's using that controller's view
+ */
+USTRUCT(BlueprintType)
+struct FPeripheryAimRay
+{
+	GENERATED_BODY()
+
+	/** Where the ray starts (the camera's view location) */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Trace") FVector Origin = FVector::ZeroVector;
+	
+	/** The normalized direction of the ray (where the camera is aiming) */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Trace") FVector Direction = FVector::ForwardVector;
+};
+
+
+/**
+ *	A stable handle to an object in the periphery object registry. The generation changes once the object is unregistered, so handles to destroyed objects are safely invalid
+ */
+USTRUCT(BlueprintType)
+struct FPeripheryHandle
+{
+	GENERATED_BODY()
+
+	/** The object's slot in the registry, and the generation of the slot when the object was registered. These aren't exposed to blueprint, but they're copied with the handle */
+	UPROPERTY() uint32 Index = MAX_uint32;
+	UPROPERTY() uint32 Generation = 0;
+
+	bool IsSet() const { return Generation != 0; }
+	bool operator==(const FPeripheryHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FPeripheryHandle& Other) const { return !(*this == Other); }
+	friend uint32 GetTypeHash(const FPeripheryHandle& Handle) { return HashCombine(Handle.Index, Handle.Generation); }
+};
+
+
+/** An instance of an instanced item component, the periphery's target for items that don't have their own actor */
+USTRUCT(BlueprintType)
+struct PERIPHERYSYSTEMCOMPONENT_API FPeripheryItemInstance
+{
+	GENERATED_BODY()
+
+	/** The component the instance belongs to */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Item Instances") TObjectPtr<UPeripheryItemInstancesComponent> Component;
+
+	/** The index of the instance. Instances can be reordered once other instances are removed, the item id doesn't change */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Item Instances") int32 InstanceIndex = INDEX_NONE;
+
+	/** The item id the instance was added with */
+	UPROPERTY(BlueprintReadOnly, Category = "Peripheries|Item Instances") int32 ItemId = INDEX_NONE;
+
+	bool IsSet() const { return Component != nullptr && InstanceIndex != INDEX_NONE; }
+
+	/** Instances are the same item if they're from the same component and have the same item id, their instance index can change */
+	bool operator==(const FPeripheryItemInstance& Other) const { return Component == Other.Component && ItemId == Other.ItemId; }
+	bool operator!=(const FPeripheryItemInstance& Other) const { return !(*this == Other); }
+
+	/** Finds the instance of an instanced item component, or an unset instance if the component isn't one (or the instance doesn't have an item id) */
+	static FPeripheryItemInstance Find(const UPrimitiveComponent* Component, int32 InstanceIndex);
+};
@@ -0,0 +1,108 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "PeripheryEventChannel.h"
+#include "PeripheryRecording.h"
+#include "PeripheryTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "UObject/ObjectKey.h"
+#include "PeripheryWorldSubsystem.generated.h"
+
+class AController;
+struct FOverlapResult;
+struct FCollisionObjectQueryParams;
+
+
+/**
+ * World level state that's shared between every periphery component. \n\n
+ * The aim ray of each controller is computed once per frame from it's camera manager's view point, and every periphery component that's using that controller reuses it.
+ * This prevents deprojecting the same crosshair multiple times, and resolves the controller from the owner of the component instead of always using the first local player (so split screen and server owned characters trace from the right view) \n\n
+ * This also handles recording the periphery for the offline replay (Periphery.Record.Start / Periphery.Record.Stop), and the proximity queries that are shared between owners that are close to each other, and the event channels for consumers on other threads
+ */
+UCLASS()
+class PERIPHERYSYSTEMCOMPONENT_API UPeripheryWorldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+protected:
+	/** The aim rays that have been calculated this frame, keyed by the controller (or the owner if it doesn't have one) */
+	TMap<FObjectKey, FPeripheryAimRay> AimRays;
+
+	/** The frame the aim rays were calculated on */
+	uint64 AimRaysFrame = 0;
+
+	/** Records the periphery components for the offline replay */
+	FPeripheryRecorder Recorder;
+
+	/** A shared proximity query, for every owner within the same cell (of the same cell size) using the same query */
+	struct FSharedQueryKey
+	{
+		FIntVector Cell;
+		float CellSize;
+		int32 ObjectTypes;
+		float Radius;
+
+		bool operator==(const FSharedQueryKey& Other) const { return Cell == Other.Cell && CellSize == Other.CellSize && ObjectTypes == Other.ObjectTypes && Radius == Other.Radius; }
+		friend uint32 GetTypeHash(const FSharedQueryKey& Key)
+		{
+			return HashCombine(HashCombine(GetTypeHash(Key.Cell), GetTypeHash(Key.CellSize)), HashCombine(GetTypeHash(Key.ObjectTypes), GetTypeHash(Key.Radius)));
+		}
+	};
+
+	/** The proximity queries that have been performed this frame */
+	TMap<FSharedQueryKey, TSharedPtr<const TArray<FOverlapResult>>> SharedQueries;
+	uint64 SharedQueriesFrame = 0;
+	int32 NumSharedQueries = 0;
+	int32 NumSharedQueryRequests = 0;
+
+	/** The channels that receive every periphery event */
+	TArray<TSharedRef<FPeripheryEventChannel>> EventChannels;
+
+
+public:
+	virtual void Deinitialize() override;
+	
+	/**
+	 * Returns the aim ray for the owner of a periphery component. This is only calculated once per frame for each controller
+	 * @remark Characters use their controller's camera view, and anything without a controller falls back to it's eyes view point
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Trace") FPeripheryAimRay GetAimRay(const AActor* Owner);
+
+	/** Finds the controller that's responsible for an actor's view. This is the pawn's controller, the actor itself if it's a controller, or it's instigator's controller */
+	static AController* FindViewController(const AActor* Owner);
+
+	/** Calculates the aim ray for an actor without caching it */
+	static FPeripheryAimRay CalculateAimRay(const AActor* Owner, const AController* Controller);
+
+	/** Starts recording every periphery component in the world. If the filename is empty it's saved to Saved/Periphery */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Recording") bool StartRecording(const FString& Filename);
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Recording") void StopRecording();
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Recording") bool IsRecording() const;
+	FPeripheryRecorder& GetRecorder() { return Recorder; }
+
+	/**
+	 * Returns the overlaps of a proximity query that's shared with every other owner in the same cell using the same query this frame. \n\n
+	 * The query is centered on the cell and padded to cover every location within it, so the results contain everything the owner's own query would find.
+	 * Owners need to refine the results with the same test they use for their own query's results, so shared and unshared owners find the same objects
+	 */
+	TSharedPtr<const TArray<FOverlapResult>> GetSharedOverlaps(const FVector& Location, float Radius, const FCollisionObjectQueryParams& ObjectQueryParams, float CellSize);
+
+	/** The number of shared proximity queries that were performed this frame, and the number of owners that used them */
+	int32 GetNumSharedQueries() const { return NumSharedQueries; }
+	int32 GetNumSharedQueryRequests() const { return NumSharedQueryRequests; }
+
+	/**
+	 * Creates a channel that receives every periphery event, for consumers that process the events on other threads. The consumer should drain the channel regularly,
+	 * events are dropped while it's full. Channels are created and removed on the game thread
+	 */
+	TSharedRef<FPeripheryEventChannel> CreateEventChannel(uint32 Capacity = 4096);
+	void RemoveEventChannel(const TSharedRef<FPeripheryEventChannel>& EventChannel);
+
+	/** Publishes an event to every channel. Check HasEventChannels() before creating the event. This is game thread only, since the channels are added and removed on the game thread */
+	void PublishEvent(const FPeripheryEventRecord& Record) const;
+	bool HasEventChannels() const { return !EventChannels.IsEmpty(); }
+
+
+};
@@ -2,6 +2,7 @@
 
 
 #include "CoreMinimal.h"
+#include "PeripheryLagCompensation.h"
 #include "PeripheryTypes.h"
 #include "Components/ActorComponent.h" 
 #include "PlayerPeripheriesComponent.generated.h"
@@ -12,16 +13,51 @@ DECLARE_LOG_CATEGORY_EXTERN(PeripheryLog, Log, All);
 /** Periphery delegates */
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_SixParams(FObjectInRadiusDelegate, AActor*, Actor, UPrimitiveComponent*, OverlappedComponent, UPrimitiveComponent*, OtherComp, int32, OtherBodyIndex, bool, bFromSweep, const FHitResult&, SweepResult);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FObjectOutsideOfRadiusDelegate, AActor*, Actor, UPrimitiveComponent*, OverlappedComponent, UPrimitiveComponent*, OtherComp, int32, OtherBodyIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FObjectInRadiusRingDelegate, AActor*, Actor, int32, RingIndex, FName, RingName);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FObjectOutsideOfRadiusRingDelegate, AActor*, Actor, int32, RingIndex, FName, RingName);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_SixParams(FObjectInPeripheryConeDelegate, AActor*, Actor, UPrimitiveComponent*, OverlappedComponent, UPrimitiveComponent*, OtherComp, int32, OtherBodyIndex, bool, bFromSweep, const FHitResult&, SweepResult);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FObjectOutsideOfPeripheryConeDelegate, AActor*, Actor, UPrimitiveComponent*, OverlappedComponent, UPrimitiveComponent*, OtherComp, int32, OtherBodyIndex);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FObjectInPeripheryTraceDelegate, AActor*, Actor, ACharacter*, Insigator, const FHitResult&, SweepResult);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_ThreeParams(FObjectOutsideOfPeripheryTraceDelegate, AActor*, Actor, ACharacter*, Insigator, const FHitResult&, SweepResult);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_SixParams(FOnItemOverlapBeginDelegate, AActor*, Item, UPrimitiveComponent*, OverlappedComponent, UPrimitiveComponent*, OtherComp, int32, OtherBodyIndex, bool, bFromSweep, const FHitResult&, SweepResult);
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_FourParams(FOnItemOverlapEndDelegate, AActor*, Item, UPrimitiveComponent*, OverlappedComponent, UPrimitiveComponent*, OtherComp, int32, OtherBodyIndex);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FPeripheryItemInstanceDelegate, const FPeripheryItemInstance&, Instance, ACharacter*, Instigator);
 
 
 class USphereComponent;
 class IPeripheryObjectInterface;
+class FPeripheryRecorder;
+class UPeripheryConfig;
+class UPeripheryItemInstancesComponent;
+
+
+/** An object near the radius rings while they're being predicted, which is evaluated again once it could cross one of the rings */
+struct FPeripheryRingCandidate
+{
+	/** The component that was found by the proximity query, the rings use it's bounds and collision channel */
+	TWeakObjectPtr<UPrimitiveComponent> Component;
+
+	/** The object's location relative to the owner when it was last evaluated, for the swept tests */
+	FVector RelativeLocation = FVector::ZeroVector;
+
+	/** When the object should be evaluated again. Older entries in the schedule for this object are ignored */
+	double NextEvaluationTime = 0;
+
+	/** Whether the object has been evaluated yet */
+	bool bEvaluated = false;
+
+	/** Whether the object was found by the latest proximity query */
+	bool bFound = false;
+};
+
+/** When a radius ring candidate should be evaluated again, the schedule is a heap ordered by the earliest time */
+struct FPeripheryRingEvaluation
+{
+	double Time = 0;
+	TWeakObjectPtr<AActor> Actor;
+
+	bool operator<(const FPeripheryRingEvaluation& Other) const { return Time < Other.Time; }
+};
 
 
 /**
@@ -49,6 +85,9 @@ protected:
 	/** Whether to use the item detection logic */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries") bool bItemDetection;
 
+	/** Whether to use the radius rings logic */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries") bool bRadiusRings;
+
 	/** Whether to initialize the periphery during BeginPlay. If this isn't set to true, you need to call InitPeripheryInformation() before any of the periphery logic initializes */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries") bool bInitPeripheryDuringBeginPlay;
 	
@@ -67,77 +106,72 @@ protected:
 	TObjectPtr<UStaticMeshComponent>	PeripheryCone;
 
 
-	/**** Periphery Radius ****/
-	/** The collision channel for the periphery radius sphere */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius", meta = (EditCondition = "bRadius", EditConditionHides)) TEnumAsByte<ECollisionChannel> PeripheryRadiusChannel;
-
-	/** A reference to the classes the periphery radius searches for. You can also override IsValidObjectInRadius() for custom logic to search for different things */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius", meta = (EditCondition = "bRadius", EditConditionHides)) TSubclassOf<AActor> ValidPeripheryRadiusObjects;
-
-	/** Debug the periphery radius functions */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Radius", meta = (EditCondition = "bRadius", EditConditionHides)) bool bDebugPeripheryRadius;
-
-	
-	/**** Item Detection ****/
-	/** The collision channel for the item detection sphere */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Item Detection", meta = (EditCondition = "bItemDetection", EditConditionHides)) TEnumAsByte<ECollisionChannel> ItemDetectionChannel;
-	
-	/** A reference to the classes the item detection sphere searches for. You can also override IsValidItemDetected() for custom logic to search for different things */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Item Detection", meta = (EditCondition = "bItemDetection", EditConditionHides)) TSubclassOf<AActor> ValidItemDetectionObjects;
-	
-	/** Debug the item detection functions */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Item Detection", meta = (EditCondition = "bItemDetection", EditConditionHides)) bool bDebugItemDetection;
-
-	
-	/**** Periphery Cone ****/
-	/** The collision channel for the periphery cone */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Cone", meta = (EditCondition = "bCone", EditConditionHides)) TEnumAsByte<ECollisionChannel> PeripheryConeChannel;
-	
-	/** A reference to the classes the periphery cone searches for. You can also override IsValidObjectInCone() for custom logic to search for different things */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Cone", meta = (EditCondition = "bCone", EditConditionHides)) TSubclassOf<AActor> ValidPeripheryConeObjects;
-
-	/** Debug the periphery cone functions */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Cone", meta = (EditCondition = "bCone", EditConditionHides)) bool bDebugPeripheryCone;
+	/**** Configuration ****/
+	/** The periphery's tuning, which should be shared between every character of the same archetype. If this isn't set the default config is used */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries") TObjectPtr<UPeripheryConfig> PeripheryConfig;
+
+	/** An optional config for this specific character, which is used instead of the shared config */
+	UPROPERTY(EditAnywhere, Instanced, BlueprintReadWrite, Category = "Peripheries", AdvancedDisplay) TObjectPtr<UPeripheryConfig> PeripheryConfigOverride;
+
+	/** The validators that have been overridden in blueprint, which are called through the blueprint event instead of natively (one bit for each periphery kind) */
+	uint8 ScriptValidators;
+
+#if WITH_EDITORONLY_DATA
+	/**** Deprecated ****/
+	/** The settings that moved to the periphery config. Components that changed them are given a config override with their values once they're loaded */
+	UPROPERTY() TEnumAsByte<ECollisionChannel> PeripheryRadiusChannel_DEPRECATED;
+	UPROPERTY() TSubclassOf<AActor> ValidPeripheryRadiusObjects_DEPRECATED;
+	UPROPERTY() bool bDebugPeripheryRadius_DEPRECATED;
+	UPROPERTY() TEnumAsByte<ECollisionChannel> ItemDetectionChannel_DEPRECATED;
+	UPROPERTY() TSubclassOf<AActor> ValidItemDetectionObjects_DEPRECATED;
+	UPROPERTY() bool bDebugItemDetection_DEPRECATED;
+	UPROPERTY() TEnumAsByte<ECollisionChannel> PeripheryConeChannel_DEPRECATED;
+	UPROPERTY() TSubclassOf<AActor> ValidPeripheryConeObjects_DEPRECATED;
+	UPROPERTY() bool bDebugPeripheryCone_DEPRECATED;
+	UPROPERTY() TArray<TEnumAsByte<EObjectTypeQuery>> PeripheryLineTraceObjectTypes_DEPRECATED;
+	UPROPERTY() TSubclassOf<AActor> ValidPeripheryTraceObjects_DEPRECATED;
+	UPROPERTY() float PeripheryTraceDistance_DEPRECATED;
+	UPROPERTY() float PeripheryTraceForwardOffset_DEPRECATED;
+	UPROPERTY() bool TraceShouldIgnoreOwnerActors_DEPRECATED;
+	UPROPERTY() bool bDebugPeripheryTrace_DEPRECATED;
+	UPROPERTY() bool bDrawTraceDebug_DEPRECATED;
+	UPROPERTY() FColor TraceColor_DEPRECATED = FColor::Emerald;
+	UPROPERTY() FColor TraceHitColor_DEPRECATED = FColor::Emerald;
+	UPROPERTY() float TraceDuration_DEPRECATED = 0.1;
+#endif
+
+	
+	/**** Radius Rings ****/
+	/** The actors that are currently within each of the radius rings */
+	TArray<TSet<TWeakObjectPtr<AActor>>> ActorsInRadiusRings;
+	float RadiusRingsTimeSinceUpdate;
+	int64 RadiusRingsUpdateStep;
+
+	/** The objects near the radius rings while they're being predicted, and when each of them should be evaluated again */
+	TMap<TWeakObjectPtr<AActor>, FPeripheryRingCandidate> RadiusRingCandidates;
+	TArray<FPeripheryRingEvaluation> RadiusRingSchedule;
 
 	
 	/**** Periphery Trace ****/
-	/** The object types the periphery trace searches for */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) TArray<TEnumAsByte<EObjectTypeQuery>> PeripheryLineTraceObjectTypes;
-
-	/** A reference to the classes the periphery cone searches for. You can also override IsValidTracedObject() for custom logic to search for different things */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) TSubclassOf<AActor> ValidPeripheryTraceObjects;
-
-	/** The distance of the trace */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) float PeripheryTraceDistance;
-
-	/** The offset is to help with things like third person camera adjustments so it doesn't trace over the character */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) float PeripheryTraceForwardOffset;
-
-	/** Whether the trace should ignore the owner's actors, which are captured during begin play (if this is set to true) */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) bool TraceShouldIgnoreOwnerActors;
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") TObjectPtr<AActor> TracedActor;
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") TObjectPtr<AActor> PreviousTracedActor;
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") bool bIsPreviousTraceValidPeripheryObject;
 	
-	/** Debug the periphery trace functions */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) bool bDebugPeripheryTrace;
-
-	/** Draw the debug trace */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides)) bool bDrawTraceDebug;
+	/** The registry handle of the traced actor, if it's a registered periphery object */
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") FPeripheryHandle TracedHandle;
 
-	/** The color of the trace */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace && bDrawTraceDebug", EditConditionHides)) FColor TraceColor = FColor::Emerald;
+	/** The item instance the trace is aiming at, if it's aiming at an instanced item */
+	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") FPeripheryItemInstance TracedItemInstance;
 
-	/** The color of the trace when it finds something */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace && bDrawTraceDebug", EditConditionHides)) FColor TraceHitColor = FColor::Emerald;
 
-	/** The duration of the trace */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace && bDrawTraceDebug", EditConditionHides)) float TraceDuration = 0.1;
-	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") TObjectPtr<AActor> TracedActor;
-	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") TObjectPtr<AActor> PreviousTracedActor;
-	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Trace") bool bIsPreviousTraceValidPeripheryObject;
+	/**** Item Detection ****/
+	/** The item instances that are within the item detection, which are tracked by their component and item id since the instances can be reordered */
+	TArray<FPeripheryItemInstance> DetectedItemInstances;
 
 	
 	/**** Other ****/
 	/** Does the periphery logic run on the client, server, or both? */
-	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Other", meta = (EditCondition = "bRadius || bTrace || bItemDetection || bCone", EditConditionHides)) EHandlePeripheryLogic ActivationPhase;
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Peripheries|Other", meta = (EditCondition = "bRadius || bTrace || bItemDetection || bCone || bRadiusRings", EditConditionHides)) EHandlePeripheryLogic ActivationPhase;
 	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Other") TArray<AActor*> IgnoredActors;
 	UPROPERTY(BlueprintReadWrite, Category = "Peripheries|Utilitiy") ACharacter* Player;
 
@@ -154,9 +188,19 @@ public:
 	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Radius") FObjectInRadiusDelegate ObjectInPlayerRadius;
 	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Radius") FObjectOutsideOfRadiusDelegate ObjectOutsideOfPlayerRadius;
 	
+	/** Radius Rings delegates */
+	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Radius Rings") FObjectInRadiusRingDelegate ObjectInRadiusRing;
+	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Radius Rings") FObjectOutsideOfRadiusRingDelegate ObjectOutsideOfRadiusRing;
+	
 	/** Item Detection delegates */
 	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Item Detection") FOnItemOverlapBeginDelegate OnItemOverlapBegin;
 	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Item Detection") FOnItemOverlapEndDelegate OnItemOverlapEnd;
+
+	/** Item Instance delegates, for instanced items that don't have their own actor */
+	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Item Instances") FPeripheryItemInstanceDelegate OnItemInstanceOverlapBegin;
+	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Item Instances") FPeripheryItemInstanceDelegate OnItemInstanceOverlapEnd;
+	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Item Instances") FPeripheryItemInstanceDelegate ItemInstanceInPeripheryTrace;
+	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Item Instances") FPeripheryItemInstanceDelegate ItemInstanceOutsideOfPeripheryTrace;
     	
 	/** Periphery Cone delegates */
 	UPROPERTY(BlueprintAssignable, Category = "Peripheries|Cone") FObjectInPeripheryConeDelegate ObjectInPeripheryCone;
@@ -171,6 +215,12 @@ public:
 protected:
 	virtual void BeginPlay() override;
 	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void PostLoad() override;
+
+#if WITH_EDITORONLY_DATA
+	/** Moves the settings that were changed on the component before they moved to the periphery config into a config override */
+	virtual void MigrateDeprecatedConfig();
+#endif
 	
 	/** Add collision events for the locally controlled player */
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities")
@@ -202,6 +252,39 @@ protected:
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Trace") void HandlePeripheryLineTrace();
 	virtual void HandlePeripheryLineTrace_Implementation();
 	
+	/**
+	 * Updates the radius rings. This performs a single proximity query for the largest ring, and then checks every object against each of the rings. \n\n
+	 * Activates the delegate functions ObjectInRadiusRing() and ObjectOutsideOfRadiusRing() when a valid object enters or leaves one of the rings
+	 */
+	virtual void UpdateRadiusRings();
+
+	/** Evaluates the radius ring candidates that could have crossed one of the rings since they were last evaluated. This is only used while the radius rings are being predicted */
+	virtual void UpdateRadiusRingCandidates();
+
+	/**
+	 * Checks a radius ring candidate against each of the rings and schedules when it should be evaluated again, based on how soon it could cross one of them.
+	 * Candidates that passed through a ring since they were last evaluated receive both the enter and exit events
+	 */
+	virtual void EvaluateRadiusRingCandidate(AActor* OtherActor, FPeripheryRingCandidate& Candidate, double Time);
+
+	/**
+	 * Whether an object found by the radius rings' query is within a ring. The object's bounds are checked first, and it's collision is only checked
+	 * if the bounds are partly outside of the ring, so the results don't depend on whether the query was shared
+	 */
+	virtual bool IsWithinRadiusRing(const UPrimitiveComponent* OtherComp, const FVector& Location, float Radius) const;
+
+	/** Activates the item instance events for an instanced item entering or leaving the item detection or the trace */
+	virtual void HandleItemInstanceTransition(const FPeripheryItemInstance& Instance, EPeripheryKind Kind, bool bEnter);
+
+	/** Removes an item instance that was removed from it's component from the item detection and the trace, and updates the index of the instance that took it's place */
+	virtual void OnItemInstanceRemoved(UPeripheryItemInstancesComponent* Component, int32 ItemId, int32 RemovedIndex, int32 MovedFromIndex);
+
+	/** Listens for an instanced item component's instances being removed, while one of it's instances is detected or traced */
+	void BindItemInstanceRemoved(UPeripheryItemInstancesComponent* Component);
+
+	/** Activates the radius ring events for an object entering or leaving one of the rings */
+	virtual void HandleRadiusRingTransition(AActor* OtherActor, int32 RingIndex, bool bEnter);
+	
 	/** The overlap function for items within the player's periphery radius. Adjust what items you find with IsValidObjectInRadius(), and the settings in the blueprint */
 	UFUNCTION() virtual void OnEnterRadiusPeriphery(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
 	
@@ -221,10 +304,28 @@ protected:
 	UFUNCTION() virtual void OnExitItemDetection(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
 
 	
+	/**
+	 * Whether an object is valid for one of the peripheries. This checks the config's filter for the periphery first (classes, periphery types and tags),
+	 * and then the periphery's validator (IsValidObjectInRadius() etc). Validators that aren't overridden in blueprint are called natively, so C++ overrides don't have the blueprint overhead
+	 */
+	virtual bool IsValidPeripheryObject(
+		EPeripheryKind Kind,
+		AActor* OtherActor,
+		UPrimitiveComponent* OverlappedComponent = nullptr,
+		UPrimitiveComponent* OtherComp = nullptr,
+		int32 OtherBodyIndex = 0,
+		bool bFromSweep = false,
+		const FHitResult& SweepResult = FHitResult()
+	);
+
+	/** Whether an object is valid for one of the radius rings. This checks the ring's filter first, and then IsValidObjectInRadiusRing() (natively unless it's overridden in blueprint) */
+	virtual bool IsValidRadiusRingObject(AActor* OtherActor, int32 RingIndex);
+	
 	/**
 	 * The overlap function to handle checking for valid objects within the periphery radius. Adjust this for handling your own logic for finding valid things within the player's periphery. \n\n
 	 * Activates delegate the delegate functions ObjectInPlayerRadius() and ObjectOutsideOfPlayerRadius() when a valid object is within or outside of the radius \n\n
 	 * @remarks Adjust this for handling your own logic for finding valid things within the player's periphery
+	 * @remarks This is only used once the radius filter passes
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Radius") bool IsValidObjectInRadius(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep = false, const FHitResult& SweepResult = FHitResult());
 	virtual bool IsValidObjectInRadius_Implementation(
@@ -236,10 +337,19 @@ protected:
 		const FHitResult& SweepResult = FHitResult()
 	);
 	
+	/**
+	 * The function to handle checking for valid objects within one of the radius rings. Adjust this for handling your own logic for finding valid things within the player's periphery. \n\n
+	 * Activates delegate the delegate functions ObjectInRadiusRing() and ObjectOutsideOfRadiusRing() when a valid object is within or outside of a ring \n\n
+	 * @remarks Adjust this for handling your own logic for finding valid things within the player's periphery
+	 */
+	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Radius Rings") bool IsValidObjectInRadiusRing(AActor* OtherActor, int32 RingIndex);
+	virtual bool IsValidObjectInRadiusRing_Implementation(AActor* OtherActor, int32 RingIndex);
+	
 	/**
 	 * The overlap function to handle checking for valid items within the periphery trace. Adjust this for handling your own logic for finding valid things within the player's periphery. \n\n
 	 * Activates delegate the delegate functions ObjectInPeripheryTrace() and ObjectOutsideOfPeripheryTrace() when a valid object is within or outside of the radius \n\n
 	 * @remarks Adjust this for handling your own logic for finding valid things within the player's periphery
+	 * @remarks This is only used once the trace filter passes
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Trace") bool IsValidTracedObject(AActor* OtherActor, const FHitResult& HitResult);
 	virtual bool IsValidTracedObject_Implementation(AActor* OtherActor, const FHitResult& HitResult);
@@ -248,6 +358,7 @@ protected:
 	 * The overlap function to handle checking for valid objects within the periphery cone. Adjust this for handling your own logic for finding valid things within the player's periphery. \n\n
 	 * Activates delegate the delegate functions ObjectInPeripheryCone() and ObjectOutsideOfPeripheryCone() when a valid object is within or outside of the cone \n\n
 	 * @remarks Adjust this for handling your own logic for finding valid things within the player's periphery
+	 * @remarks This is only used once the cone filter passes
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Cone") bool IsValidObjectInCone(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep = false, const FHitResult& SweepResult = FHitResult());
 	virtual bool IsValidObjectInCone_Implementation(
@@ -263,6 +374,7 @@ protected:
 	 * The overlap function to handle detecting valid items. Adjust this for handling your own logic for finding valid things for item detection. \n\n
 	 * Activates delegate the delegate functions OnItemOverlapBegin() and OnItemOverlapEnd() when a valid item is within or outside of the player's item detection \n\n
 	 * @remarks Adjust this for handling your own logic for finding valid items
+	 * @remarks This is only used once the item detection filter passes
 	 */
 	UFUNCTION(BlueprintNativeEvent, BlueprintCallable, Category = "Peripheries|Item Detection") bool IsValidItemDetected(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep = false, const FHitResult& SweepResult = FHitResult());
 	virtual bool IsValidItemDetected_Implementation(
@@ -284,9 +396,30 @@ protected:
 	 * @remarks This is called automatically if bInitPeripheryDuringBeginPlay is set to true. Otherwise, this needs to be called once the character has been initialized
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual void InitPeripheryInformation();
+
+	/** Returns the owner's aim ray for this frame, which is shared with every other periphery component using the same controller */
+	virtual FPeripheryAimRay GetPeripheryAimRay() const;
+
+	/** Finds which of the validators have been overridden in blueprint, since those need to be called through the blueprint event (one bit for each periphery kind) */
+	virtual void FindScriptValidators();
+
+	/** Publishes a periphery event to the periphery subsystem's event channels, if anything is listening. Item instance events pass the instance's item id */
+	virtual void PublishPeripheryEvent(const AActor* OtherActor, EPeripheryKind Kind, bool bEnter, int32 RingIndex = INDEX_NONE, int32 ItemId = INDEX_NONE) const;
+
+	/**
+	 * Requests or removes the highlight of an object that entered or left one of the peripheries, if the config highlights that periphery and the owner is locally controlled. \n\n
+	 * Item instances highlight the actor that owns them, with a separate request for each instance so the actor stays highlighted until every instance has left
+	 */
+	virtual void UpdatePeripheryHighlight(AActor* OtherActor, EPeripheryKind Kind, bool bEnter, int32 RingIndex = INDEX_NONE, int32 ItemId = INDEX_NONE);
+
+	/** Adds the owner's periphery information to the periphery recording. This is called every frame while the periphery is being recorded */
+	virtual void RecordPeriphery(FPeripheryRecorder& Recorder);
 	
-	/** Helper function for determining the type of overlay that should be used */
+	/** Helper function for determining the type of overlay that should be used. By default this is the type the object was registered with in the periphery object registry */
 	UFUNCTION() virtual EPeripheryType FindPeripheryType(TScriptInterface<IPeripheryObjectInterface> PeripheryObject) const;
+
+	/** The type an object was registered with in the periphery object registry, which is what the filters check. Objects that aren't registered are None */
+	EPeripheryType FindRegisteredPeripheryType(const AActor* Actor) const;
 	virtual bool GetCharacter(); 
 
 
@@ -294,6 +427,17 @@ public:
 	/** Used for networking. Determines whether the logic should be activated based on the argument passed in and if it's the client or server character */
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual bool ActivatePeripheryLogic(const EHandlePeripheryLogic HandlePeripheryLogic) const;
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual TScriptInterface<IPeripheryObjectInterface> GetTracedObject() const;
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual FPeripheryHandle GetTracedHandle() const;
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual FPeripheryItemInstance GetTracedItemInstance() const;
+
+	/**
+	 * Creates a claim of what the periphery trace is currently aiming at, for the client to send to the server with it's interaction requests.
+	 * The server validates it with the periphery lag compensation (SubmitTraceClaim()) instead of tracing again
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Trace") virtual FPeripheryTraceClaim CreateTraceClaim() const;
+
+	/** Returns the config the periphery is using. This is the override if there is one, then the shared config, and otherwise the default config. It's const because the shared config and the default config are used by every component */
+	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") const UPeripheryConfig* GetPeripheryConfig() const;
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual USphereComponent* GetPeripheryRadius();
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual UStaticMeshComponent* GetPeripheryCone();
 	UFUNCTION(BlueprintCallable, Category = "Peripheries|Utilities") virtual USphereComponent* GetItemDetection();
@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+
+public class PeripherySystemMass : ModuleRules
+{
+	public PeripherySystemMass(ReadOnlyTargetRules Target) : base(Target)
+	{
+		PCHUsage = ModuleRules.PCHUsageMode.UseExplicitOrSharedPCHs;
+		
+		PublicDependencyModuleNames.AddRange(
+			new string[]
+			{
+				"Core",
+				"CoreUObject",
+				"Engine",
+				"StructUtils",
+				"MassEntity",
+				"MassCommon",
+				"MassSpawner",
+				"MassActors",
+				"PeripherySystemComponent"
+			}
+		);
+
+	}
+}
@@ -0,0 +1,435 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PeripheryMassProcessors.h"
+
+#include "MassActorSubsystem.h"
+#include "MassCommonFragments.h"
+#include "MassExecutionContext.h"
+#include "PeripheryDetection.h"
+#include "PeripheryMassFragments.h"
+#include "PeripheryObjectInterface.h"
+#include "PeripheryObjectRegistry.h"
+#include "PeripheryWorldSubsystem.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+
+static TAutoConsoleVariable<float> CVarPeripheryMassGridCellSize(
+	TEXT("Periphery.Mass.GridCellSize"),
+	1000.0f,
+	TEXT("The size of the grid cells the mass entities use for finding the periphery objects around them. This should be about the size of the entities' radius")
+);
+
+
+namespace PeripheryMass
+{
+	/** A periphery event for one of the registered objects */
+	struct FNotification
+	{
+		TWeakObjectPtr<AActor> Source;
+		FPeripheryHandle Handle;
+		EPeripheryKind Kind;
+		bool bEnter;
+	};
+
+	FORCEINLINE bool HandleLess(const FPeripheryHandle& A, const FPeripheryHandle& B)
+	{
+		return A.Index != B.Index ? A.Index < B.Index : A.Generation < B.Generation;
+	}
+
+	/** Adds the enter and exit events between the previous and current objects. Both of these need to be sorted by their handles */
+	void AddTransitions(const TConstArrayView<FPeripheryHandle> Previous, const TConstArrayView<FPeripheryHandle> Current, AActor* Source, const EPeripheryKind Kind, TArray<FNotification>& OutNotifications)
+	{
+		int32 PreviousIndex = 0;
+		int32 CurrentIndex = 0;
+		while (PreviousIndex < Previous.Num() || CurrentIndex < Current.Num())
+		{
+			if (CurrentIndex == Current.Num() || (PreviousIndex < Previous.Num() && HandleLess(Previous[PreviousIndex], Current[CurrentIndex])))
+			{
+				OutNotifications.Add({Source, Previous[PreviousIndex++], Kind, false});
+			}
+			else if (PreviousIndex == Previous.Num() || HandleLess(Current[CurrentIndex], Previous[PreviousIndex]))
+			{
+				OutNotifications.Add({Source, Current[CurrentIndex++], Kind, true});
+			}
+			else
+			{
+				PreviousIndex++;
+				CurrentIndex++;
+			}
+		}
+	}
+
+	/**
+	 * A uniform grid of the registered objects, which is built once per update so each entity only checks the objects around it. \n\n
+	 * Objects are added to every cell their bounds (and location) overlap, so the queries mark the objects they've found to skip the duplicates.
+	 * Objects that would cover too many cells are checked by every query instead
+	 */
+	struct FObjectGrid
+	{
+		static constexpr int32 MaxObjectCells = 64;
+
+		double CellSize = 1000;
+		TMap<FIntVector, TArray<int32>> Cells;
+		TArray<int32> LargeObjects;
+		TBitArray<> Found;
+		TArray<int32> FoundObjects;
+
+		FIntVector GetCell(const FVector& Location) const
+		{
+			return FIntVector(FMath::FloorToInt(Location.X / CellSize), FMath::FloorToInt(Location.Y / CellSize), FMath::FloorToInt(Location.Z / CellSize));
+		}
+
+		void Build(const UPeripheryObjectRegistry& Registry, const double InCellSize)
+		{
+			CellSize = FMath::Max(InCellSize, 1.0);
+			Cells.Reset();
+			LargeObjects.Reset();
+			Found.Init(false, Registry.Num());
+
+			const TConstArrayView<FVector> Positions = Registry.GetPositions();
+			const TConstArrayView<FVector3f> BoundsMin = Registry.GetBoundsMin();
+			const TConstArrayView<FVector3f> BoundsMax = Registry.GetBoundsMax();
+			for (int32 PackedIndex = 0; PackedIndex < Registry.Num(); PackedIndex++)
+			{
+				FBox Bounds(FVector(BoundsMin[PackedIndex]), FVector(BoundsMax[PackedIndex]));
+				Bounds += Positions[PackedIndex];
+
+				const FIntVector MinCell = GetCell(Bounds.Min);
+				const FIntVector MaxCell = GetCell(Bounds.Max);
+				const FIntVector NumCells = MaxCell - MinCell + FIntVector(1);
+				if ((int64)NumCells.X * NumCells.Y * NumCells.Z > MaxObjectCells)
+				{
+					LargeObjects.Add(PackedIndex);
+					continue;
+				}
+
+				for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+				for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+				{
+					Cells.FindOrAdd(FIntVector(X, Y, Z)).Add(PackedIndex);
+				}
+			}
+		}
+
+		/** Adds objects that haven't been found yet */
+		void AddObjects(const TArray<int32>& Objects, TArray<int32>& OutCandidates)
+		{
+			for (const int32 PackedIndex : Objects)
+			{
+				if (Found[PackedIndex]) continue;
+				Found[PackedIndex] = true;
+				FoundObjects.Add(PackedIndex);
+				OutCandidates.Add(PackedIndex);
+			}
+		}
+
+		void AddCell(const FIntVector& Cell, TArray<int32>& OutCandidates)
+		{
+			if (const TArray<int32>* CellObjects = Cells.Find(Cell)) AddObjects(*CellObjects, OutCandidates);
+		}
+
+		/** Adds the objects in the cells that overlap a box */
+		void QueryBox(const FBox& Box, TArray<int32>& OutCandidates)
+		{
+			AddObjects(LargeObjects, OutCandidates);
+			const FIntVector MinCell = GetCell(Box.Min);
+			const FIntVector MaxCell = GetCell(Box.Max);
+			for (int32 X = MinCell.X; X <= MaxCell.X; X++)
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; Y++)
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; Z++)
+			{
+				AddCell(FIntVector(X, Y, Z), OutCandidates);
+			}
+		}
+
+		/** Adds the objects in the cells a ray passes through, stepping from cell to cell along the ray */
+		void QueryRay(const FVector& Origin, const FVector& Direction, const double Distance, TArray<int32>& OutCandidates)
+		{
+			AddObjects(LargeObjects, OutCandidates);
+			FIntVector Cell = GetCell(Origin);
+			const FIntVector EndCell = GetCell(Origin + Direction * Distance);
+			FIntVector Step;
+			FVector NextBoundary;
+			FVector BoundaryStep;
+			for (int32 Axis = 0; Axis < 3; Axis++)
+			{
+				if (FMath::IsNearlyZero(Direction[Axis]))
+				{
+					Step[Axis] = 0;
+					NextBoundary[Axis] = UE_BIG_NUMBER;
+					BoundaryStep[Axis] = UE_BIG_NUMBER;
+					continue;
+				}
+
+				Step[Axis] = Direction[Axis] > 0 ? 1 : -1;
+				NextBoundary[Axis] = ((Cell[Axis] + (Step[Axis] > 0 ? 1 : 0)) * CellSize - Origin[Axis]) / Direction[Axis];
+				BoundaryStep[Axis] = CellSize / FMath::Abs(Direction[Axis]);
+			}
+
+			const int32 MaxSteps = FMath::Abs(EndCell.X - Cell.X) + FMath::Abs(EndCell.Y - Cell.Y) + FMath::Abs(EndCell.Z - Cell.Z);
+			for (int32 StepIndex = 0; StepIndex <= MaxSteps; StepIndex++)
+			{
+				AddCell(Cell, OutCandidates);
+
+				const int32 Axis = NextBoundary.X < NextBoundary.Y ? (NextBoundary.X < NextBoundary.Z ? 0 : 2) : (NextBoundary.Y < NextBoundary.Z ? 1 : 2);
+				if (NextBoundary[Axis] > Distance) break;
+				Cell[Axis] += Step[Axis];
+				NextBoundary[Axis] += BoundaryStep[Axis];
+			}
+		}
+
+		/** Clears the found objects for the next query */
+		void ResetFound()
+		{
+			for (const int32 PackedIndex : FoundObjects) Found[PackedIndex] = false;
+			FoundObjects.Reset();
+		}
+	};
+
+	/** Sends the periphery interface events, and publishes them to the event channels. Objects that have been removed from the registry since only receive the published events */
+	void SendNotifications(const UPeripheryObjectRegistry& Registry, const TConstArrayView<FNotification> Notifications)
+	{
+		const UWorld* World = Registry.GetWorld();
+		const UPeripheryWorldSubsystem* PeripherySubsystem = World ? World->GetSubsystem<UPeripheryWorldSubsystem>() : nullptr;
+		if (PeripherySubsystem && PeripherySubsystem->HasEventChannels())
+		{
+			for (const FNotification& Notification : Notifications)
+			{
+				const AActor* Source = Notification.Source.Get();
+				const AActor* Actor = Registry.GetActor(Notification.Handle);
+				FPeripheryEventRecord Record;
+				Record.OwnerId = Source ? Source->GetUniqueID() : 0;
+				Record.ObjectId = Actor ? Actor->GetUniqueID() : 0;
+				Record.Handle = Notification.Handle;
+				Record.Timestamp = World->GetTimeSeconds();
+				Record.Kind = Notification.Kind;
+				Record.bEnter = Notification.bEnter;
+				PeripherySubsystem->PublishEvent(Record);
+			}
+		}
+
+		for (const FNotification& Notification : Notifications)
+		{
+			const int32 PackedIndex = Registry.GetPackedIndex(Notification.Handle);
+			AActor* Actor = PackedIndex != INDEX_NONE ? Registry.GetActor(Notification.Handle) : nullptr;
+			if (!Actor || !EnumHasAnyFlags(Registry.GetFlags()[PackedIndex], EPeripheryObjectFlags::EPO_PeripheryInterface)) continue;
+
+			AActor* Source = Notification.Source.Get();
+			const EPeripheryType PeripheryType = Registry.GetTypes()[PackedIndex];
+			switch (Notification.Kind)
+			{
+				case EPeripheryKind::EPK_Radius:
+					if (Notification.bEnter) IPeripheryObjectInterface::Execute_WithinPlayerRadiusPeriphery(Actor, Source, PeripheryType);
+					else IPeripheryObjectInterface::Execute_OutsideOfPlayerRadiusPeriphery(Actor, Source, PeripheryType);
+					break;
+				case EPeripheryKind::EPK_Cone:
+					if (Notification.bEnter) IPeripheryObjectInterface::Execute_WithinPlayerConePeriphery(Actor, Source, PeripheryType);
+					else IPeripheryObjectInterface::Execute_OutsideOfConePeriphery(Actor, Source, PeripheryType);
+					break;
+				case EPeripheryKind::EPK_Trace:
+					if (Notification.bEnter) IPeripheryObjectInterface::Execute_WithinPlayerTracePeriphery(Actor, Source, PeripheryType);
+					else IPeripheryObjectInterface::Execute_OutsideOfPlayerTracePeriphery(Actor, Source, PeripheryType);
+					break;
+				default:
+					break;
+			}
+		}
+	}
+}
+
+
+
+
+#pragma region Periphery Processor
+UPeripheryMassProcessor::UPeripheryMassProcessor()
+{
+	// The periphery logic runs on the server by default (like the periphery component), and the events are sent to actors so this needs to be on the game thread
+	ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	ProcessingPhase = EMassProcessingPhase::PostPhysics;
+	bRequiresGameThreadExecution = true;
+}
+
+
+void UPeripheryMassProcessor::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FTransformFragment>(EMassFragmentAccess::ReadOnly);
+	EntityQuery.AddRequirement<FPeripheryMassFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMassActorFragment>(EMassFragmentAccess::ReadWrite, EMassFragmentPresence::Optional);
+	EntityQuery.AddConstSharedRequirement<FPeripheryMassParameters>();
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+
+void UPeripheryMassProcessor::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UPeripheryObjectRegistry* Registry = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	if (!Registry) return;
+
+	const TConstArrayView<FPeripheryHandle> Handles = Registry->GetHandles();
+	const TConstArrayView<FVector> Positions = Registry->GetPositions();
+	const TConstArrayView<FVector3f> BoundsMin = Registry->GetBoundsMin();
+	const TConstArrayView<FVector3f> BoundsMax = Registry->GetBoundsMax();
+	const TConstArrayView<EPeripheryObjectFlags> Flags = Registry->GetFlags();
+
+	TArray<PeripheryMass::FNotification> Notifications;
+	TArray<int32> Candidates;
+	PeripheryMass::FObjectGrid Grid;
+	bool bGridBuilt = false;
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const int32 NumEntities = ChunkContext.GetNumEntities();
+		const TConstArrayView<FTransformFragment> Transforms = ChunkContext.GetFragmentView<FTransformFragment>();
+		const TArrayView<FPeripheryMassFragment> Peripheries = ChunkContext.GetMutableFragmentView<FPeripheryMassFragment>();
+		const TArrayView<FMassActorFragment> ActorFragments = ChunkContext.GetMutableFragmentView<FMassActorFragment>();
+		const FPeripheryMassParameters& Parameters = ChunkContext.GetConstSharedFragment<FPeripheryMassParameters>();
+
+		// Find the entities that should be updated
+		TArray<int32, TInlineAllocator<128>> UpdatedEntities;
+		for (int32 EntityIndex = 0; EntityIndex < NumEntities; EntityIndex++)
+		{
+			FPeripheryMassFragment& Periphery = Peripheries[EntityIndex];
+			Periphery.TimeUntilUpdate -= ChunkContext.GetDeltaTimeSeconds();
+			if (Periphery.TimeUntilUpdate > 0) continue;
+
+			Periphery.TimeUntilUpdate = Parameters.UpdateInterval;
+			UpdatedEntities.Add(EntityIndex);
+		}
+		if (UpdatedEntities.IsEmpty()) return;
+
+		// The grid is only built on the updates where an entity needs it
+		if (!bGridBuilt)
+		{
+			Grid.Build(*Registry, CVarPeripheryMassGridCellSize.GetValueOnGameThread());
+			bGridBuilt = true;
+		}
+
+		const float ConeCosHalfAngle = FMath::Cos(FMath::DegreesToRadians(Parameters.ConeHalfAngle));
+		TArray<FPeripheryHandle, TInlineAllocator<8>> ObjectsInRadius;
+		TArray<FPeripheryHandle, TInlineAllocator<8>> ObjectsInCone;
+		for (const int32 EntityIndex : UpdatedEntities)
+		{
+			FPeripheryMassFragment& Periphery = Peripheries[EntityIndex];
+			const FTransform& Transform = Transforms[EntityIndex].GetTransform();
+			const FVector Location = Transform.GetLocation();
+			const FVector EyeLocation = Location + FVector(0, 0, Parameters.EyeHeight);
+			const FVector Forward = Transform.GetRotation().GetForwardVector();
+			const FVector InverseForward = PeripheryDetection::GetInverseDirection(Forward);
+
+			// Entities with an actor shouldn't detect themselves
+			AActor* Source = ActorFragments.Num() ? ActorFragments[EntityIndex].GetMutable() : nullptr;
+			const FPeripheryHandle SourceHandle = Registry->FindHandle(Source);
+
+			// Only the objects in the cells the entity's peripheries reach are checked
+			Candidates.Reset();
+			FBox Reach(ForceInit);
+			if (Parameters.bRadius) Reach += FBox(Location - FVector(Parameters.Radius), Location + FVector(Parameters.Radius));
+			if (Parameters.bCone) Reach += FBox(EyeLocation - FVector(Parameters.ConeLength), EyeLocation + FVector(Parameters.ConeLength));
+			if (Reach.IsValid) Grid.QueryBox(Reach, Candidates);
+			if (Parameters.bTrace) Grid.QueryRay(EyeLocation, Forward, Parameters.TraceDistance, Candidates);
+			Grid.ResetFound();
+
+			ObjectsInRadius.Reset();
+			ObjectsInCone.Reset();
+			FPeripheryHandle TracedHandle;
+			double TracedDistance = Parameters.TraceDistance;
+			for (const int32 PackedIndex : Candidates)
+			{
+				const FPeripheryHandle& Handle = Handles[PackedIndex];
+				if (Handle == SourceHandle) continue;
+				if (Parameters.bOnlyPeripheryInterfaceObjects && !EnumHasAnyFlags(Flags[PackedIndex], EPeripheryObjectFlags::EPO_PeripheryInterface)) continue;
+
+				if (Parameters.bRadius && PeripheryDetection::IsWithinRadius(Location, Positions[PackedIndex], Parameters.Radius))
+				{
+					ObjectsInRadius.Add(Handle);
+				}
+
+				if (Parameters.bCone && PeripheryDetection::IsWithinCone(EyeLocation, Forward, Positions[PackedIndex], Parameters.ConeLength, ConeCosHalfAngle))
+				{
+					ObjectsInCone.Add(Handle);
+				}
+
+				double Distance;
+				if (Parameters.bTrace
+					&& PeripheryDetection::IntersectRayBox(EyeLocation, InverseForward, FVector(BoundsMin[PackedIndex]), FVector(BoundsMax[PackedIndex]), TracedDistance, Distance)
+					&& (!TracedHandle.IsSet() || Distance < TracedDistance))
+				{
+					TracedHandle = Handle;
+					TracedDistance = Distance;
+				}
+			}
+
+			// Periphery transitions
+			ObjectsInRadius.Sort(&PeripheryMass::HandleLess);
+			ObjectsInCone.Sort(&PeripheryMass::HandleLess);
+			PeripheryMass::AddTransitions(Periphery.ObjectsInRadius, ObjectsInRadius, Source, EPeripheryKind::EPK_Radius, Notifications);
+			PeripheryMass::AddTransitions(Periphery.ObjectsInCone, ObjectsInCone, Source, EPeripheryKind::EPK_Cone, Notifications);
+			Periphery.ObjectsInRadius = ObjectsInRadius;
+			Periphery.ObjectsInCone = ObjectsInCone;
+
+			const PeripheryDetection::FTraceTransition Transition = PeripheryDetection::ResolveTraceTransition(
+				Periphery.TracedHandle.IsSet(), true,
+				TracedHandle.IsSet(), true,
+				TracedHandle == Periphery.TracedHandle
+			);
+			if (Transition.bExitPrevious) Notifications.Add({Source, Periphery.TracedHandle, EPeripheryKind::EPK_Trace, false});
+			if (Transition.bEnterCurrent) Notifications.Add({Source, TracedHandle, EPeripheryKind::EPK_Trace, true});
+			Periphery.TracedHandle = TracedHandle;
+		}
+	});
+
+	PeripheryMass::SendNotifications(*Registry, Notifications);
+}
+#pragma endregion
+
+
+
+
+#pragma region Removal Observer
+UPeripheryMassRemovalObserver::UPeripheryMassRemovalObserver()
+{
+	ObservedType = FPeripheryMassFragment::StaticStruct();
+	Operation = EMassObservedOperation::Remove;
+	ExecutionFlags = (int32)(EProcessorExecutionFlags::Standalone | EProcessorExecutionFlags::Server);
+	bRequiresGameThreadExecution = true;
+}
+
+
+void UPeripheryMassRemovalObserver::ConfigureQueries()
+{
+	EntityQuery.AddRequirement<FPeripheryMassFragment>(EMassFragmentAccess::ReadWrite);
+	EntityQuery.AddRequirement<FMassActorFragment>(EMassFragmentAccess::ReadWrite, EMassFragmentPresence::Optional);
+	EntityQuery.RegisterWithProcessor(*this);
+}
+
+
+void UPeripheryMassRemovalObserver::Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context)
+{
+	const UPeripheryObjectRegistry* Registry = GetWorld() ? GetWorld()->GetSubsystem<UPeripheryObjectRegistry>() : nullptr;
+	if (!Registry) return;
+
+	TArray<PeripheryMass::FNotification> Notifications;
+	EntityQuery.ForEachEntityChunk(EntityManager, Context, [&](FMassExecutionContext& ChunkContext)
+	{
+		const TArrayView<FPeripheryMassFragment> Peripheries = ChunkContext.GetMutableFragmentView<FPeripheryMassFragment>();
+		const TArrayView<FMassActorFragment> ActorFragments = ChunkContext.GetMutableFragmentView<FMassActorFragment>();
+		for (int32 EntityIndex = 0; EntityIndex < ChunkContext.GetNumEntities(); EntityIndex++)
+		{
+			FPeripheryMassFragment& Periphery = Peripheries[EntityIndex];
+			AActor* Source = ActorFragments.Num() ? ActorFragments[EntityIndex].GetMutable() : nullptr;
+
+			PeripheryMass::AddTransitions(Periphery.ObjectsInRadius, {}, Source, EPeripheryKind::EPK_Radius, Notifications);
+			PeripheryMass::AddTransitions(Periphery.ObjectsInCone, {}, Source, EPeripheryKind::EPK_Cone, Notifications);
+			if (Periphery.TracedHandle.IsSet()) Notifications.Add({Source, Periphery.TracedHandle, EPeripheryKind::EPK_Trace, false});
+
+			Periphery.ObjectsInRadius.Reset();
+			Periphery.ObjectsInCone.Reset();
+			Periphery.TracedHandle = FPeripheryHandle();
+		}
+	});
+
+	PeripheryMass::SendNotifications(*Registry, Notifications);
+}
+#pragma endregion
@@ -0,0 +1,17 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "PeripherySystemMass.h"
+
+#define LOCTEXT_NAMESPACE "FPeripherySystemMassModule"
+
+void FPeripherySystemMassModule::StartupModule()
+{
+}
+
+void FPeripherySystemMassModule::ShutdownModule()
+{
+}
+
+#undef LOCTEXT_NAMESPACE
+	
+IMPLEMENT_MODULE(FPeripherySystemMassModule, PeripherySystemMass)
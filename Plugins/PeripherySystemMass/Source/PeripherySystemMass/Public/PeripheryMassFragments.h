@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTypes.h"
+#include "PeripheryTypes.h"
+#include "PeripheryMassFragments.generated.h"
+
+
+/** The periphery settings of a mass entity. These are shared between every entity that's created from the same config */
+USTRUCT()
+struct PERIPHERYSYSTEMMASS_API FPeripheryMassParameters : public FMassConstSharedFragment
+{
+	GENERATED_BODY()
+
+	/** Whether to use the periphery radius logic */
+	UPROPERTY(EditAnywhere, Category = "Peripheries") bool bRadius = true;
+
+	/** Whether to use the periphery cone logic */
+	UPROPERTY(EditAnywhere, Category = "Peripheries") bool bCone = false;
+
+	/** Whether to use the periphery trace logic */
+	UPROPERTY(EditAnywhere, Category = "Peripheries") bool bTrace = false;
+
+	/** Whether only objects that implement the periphery interface should be detected. Otherwise everything in the periphery object registry is */
+	UPROPERTY(EditAnywhere, Category = "Peripheries") bool bOnlyPeripheryInterfaceObjects = true;
+
+	/** The radius of the entity's periphery */
+	UPROPERTY(EditAnywhere, Category = "Peripheries|Radius", meta = (EditCondition = "bRadius", EditConditionHides, ClampMin = "0")) float Radius = 1340;
+
+	/** The length of the entity's periphery cone */
+	UPROPERTY(EditAnywhere, Category = "Peripheries|Cone", meta = (EditCondition = "bCone", EditConditionHides, ClampMin = "0")) float ConeLength = 1200;
+
+	/** The angle from the center of the cone to it's edge, in degrees */
+	UPROPERTY(EditAnywhere, Category = "Peripheries|Cone", meta = (EditCondition = "bCone", EditConditionHides, ClampMin = "0", ClampMax = "180")) float ConeHalfAngle = 35;
+
+	/** The distance of the trace */
+	UPROPERTY(EditAnywhere, Category = "Peripheries|Trace", meta = (EditCondition = "bTrace", EditConditionHides, ClampMin = "0")) float TraceDistance = 6400;
+
+	/** The height of the cone and the trace above the entity's location */
+	UPROPERTY(EditAnywhere, Category = "Peripheries", meta = (EditCondition = "bCone || bTrace", EditConditionHides)) float EyeHeight = 64;
+
+	/** How often the periphery is updated, in seconds. If this is zero it's updated every frame */
+	UPROPERTY(EditAnywhere, Category = "Peripheries", meta = (ClampMin = "0")) float UpdateInterval = 0.1;
+};
+
+
+/** The periphery state of a mass entity, which is the objects that are currently within each of it's peripheries */
+USTRUCT()
+struct PERIPHERYSYSTEMMASS_API FPeripheryMassFragment : public FMassFragment
+{
+	GENERATED_BODY()
+
+	/** The objects within the radius and cone, sorted by their handles so the changes can be found in a single pass */
+	TArray<FPeripheryHandle, TInlineAllocator<8>> ObjectsInRadius;
+	TArray<FPeripheryHandle, TInlineAllocator<8>> ObjectsInCone;
+
+	/** The object the entity's trace is aimed at */
+	FPeripheryHandle TracedHandle;
+
+	/** The time until the next update */
+	float TimeUntilUpdate = 0;
+};
@@ -0,0 +1,53 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityQuery.h"
+#include "MassObserverProcessor.h"
+#include "MassProcessor.h"
+#include "PeripheryMassProcessors.generated.h"
+
+
+/**
+ * Updates the peripheries of mass entities. \n\n
+ * The registered periphery objects are added to a uniform grid once per update, and each entity only checks the objects in the cells around it's radius and cone,
+ * and the cells along it's trace (Periphery.Mass.GridCellSize adjusts the size of the cells).
+ * The trace is checked against the bounds of the objects instead of tracing against the world, so it doesn't account for anything blocking it. \n\n
+ * The enter and exit events are sent to the objects once every entity has been processed, since the events can change the registry
+ */
+UCLASS()
+class PERIPHERYSYSTEMMASS_API UPeripheryMassProcessor : public UMassProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UPeripheryMassProcessor();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+
+
+};
+
+
+/** Sends the exit events for everything that's within an entity's periphery once the entity is destroyed (or loses it's periphery) */
+UCLASS()
+class PERIPHERYSYSTEMMASS_API UPeripheryMassRemovalObserver : public UMassObserverProcessor
+{
+	GENERATED_BODY()
+
+public:
+	UPeripheryMassRemovalObserver();
+
+protected:
+	virtual void ConfigureQueries() override;
+	virtual void Execute(FMassEntityManager& EntityManager, FMassExecutionContext& Context) override;
+
+	FMassEntityQuery EntityQuery;
+
+
+};
@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MassEntityTraitBase.h"
+#include "PeripheryMassFragments.h"
+#include "PeripheryMassTrait.generated.h"
+
+
+/**
+ * Adds the periphery logic to mass entities (for crowds and other agents that aren't characters). \n\n
+ * The entities detect the objects in the periphery object registry that are within their radius, cone and trace, and send the same periphery interface events as the periphery component.
+ * The source character of the events is the entity's actor if it has one, otherwise it's nullptr
+ */
+UCLASS(meta = (DisplayName = "Periphery"))
+class PERIPHERYSYSTEMMASS_API UPeripheryMassTrait : public UMassEntityTraitBase
+{
+	GENERATED_BODY()
+
+protected:
+	UPROPERTY(EditAnywhere, Category = "Peripheries") FPeripheryMassParameters Parameters;
+
+	virtual void BuildTemplate(FMassEntityTemplateBuildContext& BuildContext, const UWorld& World) const override;
+
+
+};